@@ -0,0 +1,138 @@
+/*
+ * Release signal for one periodic service thread, built on a Linux futex.
+ *
+ * The releaser bumps a 32-bit sequence number and, only if the service
+ * thread is parked, wakes it with one FUTEX_WAKE. The service thread
+ * remembers the last sequence it consumed, so wait() reports how many
+ * releases arrived since the previous job: 1 on time, n > 1 when the
+ * previous job overran and n - 1 releases were missed. A counting_semaphore
+ * used the same way silently absorbs those releases (release() past max()
+ * is even undefined behaviour).
+ *
+ * Cost: release() is one atomic add plus one load when the waiter is
+ * running, and one futex syscall when it is parked. Single waiter, any
+ * number of releasers.
+ *
+ * FutexMailbox adds a small record to every release (when it was
+ * scheduled, handled, posted), so the waiter reads the stamps of the
+ * release it consumed rather than fields the releaser may already have
+ * rewritten for the next one. Single releaser there: concurrent releasers
+ * must serialize their post() calls.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "SeqLock.hpp"
+
+class FutexRelease
+{
+public:
+    FutexRelease() = default;
+    FutexRelease(const FutexRelease&) = delete;
+    FutexRelease& operator=(const FutexRelease&) = delete;
+
+    void release() noexcept
+    {
+        // seq_cst pairs with the waiter's store to _parked / load of
+        // _sequence: either the waiter sees the new sequence and does not
+        // sleep, or we see it parked and wake it
+        _sequence.fetch_add(1, std::memory_order_seq_cst);
+        if (_parked.load(std::memory_order_seq_cst) != 0) {
+            _futex(FUTEX_WAKE_PRIVATE, 1);
+        }
+    }
+
+    // Service thread only. Blocks until at least one release arrived since
+    // the previous wait() and returns how many did.
+    uint32_t wait() noexcept
+    {
+        uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        while (sequence == _consumed) {
+            _parked.store(1, std::memory_order_seq_cst);
+            sequence = _sequence.load(std::memory_order_seq_cst);
+            if (sequence == _consumed) {
+                // Returns at once if _sequence moved on since the load
+                _futex(FUTEX_WAIT_PRIVATE, sequence);
+            }
+            _parked.store(0, std::memory_order_relaxed);
+            sequence = _sequence.load(std::memory_order_acquire);
+        }
+
+        uint32_t releases = sequence - _consumed;
+        _consumed = sequence;
+        return releases;
+    }
+
+private:
+    std::atomic<uint32_t> _sequence{0};
+    std::atomic<uint32_t> _parked{0};
+    uint32_t _consumed{0};   // waiter-private
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit int");
+
+    long _futex(int op, uint32_t value) noexcept
+    {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&_sequence), op, value, nullptr, nullptr, 0);
+    }
+};
+
+template <typename Record, uint32_t Slots = 8>
+class FutexMailbox
+{
+    static_assert(std::is_trivially_copyable_v<Record>, "records are published through a SeqLock");
+
+public:
+    struct Delivery {
+        uint32_t releases;   // as FutexRelease::wait()
+        Record record;       // of the newest release consumed
+    };
+
+    FutexMailbox() = default;
+    FutexMailbox(const FutexMailbox&) = delete;
+    FutexMailbox& operator=(const FutexMailbox&) = delete;
+
+    // Releaser only. The record is in its slot before the release is
+    // visible, so the waiter never sees a release without it.
+    void post(const Record& record) noexcept
+    {
+        ++_posted;
+        _slots[_posted % Slots].store(Slot{_posted, record});
+        _release.release();
+    }
+
+    // Service thread only. A slot is reused Slots releases later; a waiter
+    // preempted that long between its wakeup and the read finds a newer
+    // record there, and takes that release and the ones before it instead
+    // (its post() has already stored it, so its release() is imminent).
+    Delivery wait() noexcept
+    {
+        uint32_t releases = _release.wait();
+        _consumed += releases;
+        Slot slot = _slots[_consumed % Slots].load();
+        while (slot.sequence != _consumed) {
+            uint32_t more = _release.wait();
+            releases += more;
+            _consumed += more;
+            slot = _slots[_consumed % Slots].load();
+        }
+        return Delivery{releases, slot.record};
+    }
+
+private:
+    struct Slot {
+        uint32_t sequence;
+        Record record;
+    };
+
+    FutexRelease _release;
+    std::array<SeqLock<Slot>, Slots> _slots{};
+    uint32_t _posted{0};     // releaser-private
+    uint32_t _consumed{0};   // waiter-private
+};
@@ -0,0 +1,114 @@
+/*
+ * Fixed-capacity, move-only replacement for std::function.
+ *
+ * The callable is always stored inside the object (Capacity bytes), so
+ * constructing a Service never touches the heap, and a callable that does
+ * not fit is a compile error rather than a hidden allocation. Calling it
+ * is one indirect call with no empty check; calling an empty
+ * InplaceFunction is undefined.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename Signature, size_t Capacity = 64>
+class InplaceFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+public:
+    InplaceFunction() noexcept = default;
+
+    template <typename F, typename D = std::decay_t<F>>
+        requires (!std::is_same_v<D, InplaceFunction> && std::is_invocable_r_v<R, D&, Args...>)
+    InplaceFunction(F&& f)
+    {
+        static_assert(sizeof(D) <= Capacity, "callable does not fit, raise the InplaceFunction capacity");
+        static_assert(alignof(D) <= alignof(std::max_align_t), "callable is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<D>, "callable must be nothrow movable");
+
+        ::new (static_cast<void*>(_storage)) D(std::forward<F>(f));
+        _invoke = &_invokeImpl<D>;
+        _manage = &_manageImpl<D>;
+    }
+
+    InplaceFunction(InplaceFunction&& other) noexcept
+    {
+        _moveFrom(other);
+    }
+
+    InplaceFunction& operator=(InplaceFunction&& other) noexcept
+    {
+        if (this != &other) {
+            _reset();
+            _moveFrom(other);
+        }
+        return *this;
+    }
+
+    InplaceFunction(const InplaceFunction&) = delete;
+    InplaceFunction& operator=(const InplaceFunction&) = delete;
+
+    ~InplaceFunction()
+    {
+        _reset();
+    }
+
+    R operator()(Args... args)
+    {
+        return _invoke(_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return _invoke != nullptr;
+    }
+
+private:
+    // dst == nullptr destroys src, otherwise move-constructs dst from src and destroys src
+    using Manage = void (*)(void* dst, void* src) noexcept;
+    using Invoke = R (*)(void* storage, Args&&... args);
+
+    alignas(std::max_align_t) std::byte _storage[Capacity];
+    Invoke _invoke{nullptr};
+    Manage _manage{nullptr};
+
+    template <typename D>
+    static R _invokeImpl(void* storage, Args&&... args)
+    {
+        return (*static_cast<D*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename D>
+    static void _manageImpl(void* dst, void* src) noexcept
+    {
+        D* from = static_cast<D*>(src);
+        if (dst != nullptr) {
+            ::new (dst) D(std::move(*from));
+        }
+        from->~D();
+    }
+
+    void _moveFrom(InplaceFunction& other) noexcept
+    {
+        if (other._manage != nullptr) {
+            other._manage(_storage, other._storage);
+        }
+        _invoke = std::exchange(other._invoke, nullptr);
+        _manage = std::exchange(other._manage, nullptr);
+    }
+
+    void _reset() noexcept
+    {
+        if (_manage != nullptr) {
+            _manage(nullptr, _storage);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+};
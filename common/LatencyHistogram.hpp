@@ -0,0 +1,234 @@
+/*
+ * Fixed-memory, log-linear latency histogram in integer nanoseconds
+ * (HdrHistogram-style bucketing).
+ *
+ * Values below 2^SubBucketBits ns are counted exactly; above that every
+ * power of two is split into 2^SubBucketBits equal buckets, so a recorded
+ * value is known to within 1/64 (1.6%) across the whole range. Values of
+ * 2^MaxValueBits ns (~68 s) and above land in the last bucket; min and max
+ * are always exact.
+ *
+ * record() never allocates and only does relaxed atomic adds, so it is safe
+ * on a real-time thread while other threads read percentiles. Histograms
+ * with the same layout merge bucket by bucket, in memory (merge) or across
+ * runs through a small text format (save / load).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+
+class LatencyHistogram
+{
+public:
+    static constexpr unsigned SubBucketBits = 6;
+    static constexpr unsigned MaxValueBits = 36;
+    static constexpr size_t NumBuckets = size_t{MaxValueBits - SubBucketBits + 1} << SubBucketBits;
+
+    // Percentiles printed by printPercentileRow()
+    static constexpr std::array<double, 5> Percentiles{50.0, 90.0, 99.0, 99.9, 99.99};
+
+    LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Negative values (clock skew between threads) are counted as 0
+    void record(int64_t ns) noexcept
+    {
+        uint64_t value = ns < 0 ? 0 : static_cast<uint64_t>(ns);
+        _counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        _total.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+        _raise(_max, value);
+        _lower(_min, value);
+    }
+
+    void merge(const LatencyHistogram& other) noexcept
+    {
+        for (size_t i = 0; i < NumBuckets; ++i) {
+            uint64_t n = other._counts[i].load(std::memory_order_relaxed);
+            if (n != 0) _counts[i].fetch_add(n, std::memory_order_relaxed);
+        }
+        _total.fetch_add(other._total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _sum.fetch_add(other._sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        _raise(_max, other._max.load(std::memory_order_relaxed));
+        _lower(_min, other._min.load(std::memory_order_relaxed));
+    }
+
+    void reset() noexcept
+    {
+        for (auto& count : _counts) count.store(0, std::memory_order_relaxed);
+        _total.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+        _min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return _total.load(std::memory_order_relaxed); }
+    int64_t max() const { return static_cast<int64_t>(_max.load(std::memory_order_relaxed)); }
+
+    int64_t min() const
+    {
+        return count() == 0 ? 0 : static_cast<int64_t>(_min.load(std::memory_order_relaxed));
+    }
+
+    double mean() const
+    {
+        uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(_sum.load(std::memory_order_relaxed)) / n;
+    }
+
+    // Upper bound of the bucket holding the sample at this percentile,
+    // capped at the exact max
+    int64_t valueAtPercentile(double percentile) const
+    {
+        uint64_t total = 0;
+        for (const auto& count : _counts) total += count.load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+
+        auto target = static_cast<uint64_t>(percentile / 100.0 * total + 0.5);
+        if (target == 0) target = 1;
+        if (target > total) target = total;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < NumBuckets; ++i) {
+            seen += _counts[i].load(std::memory_order_relaxed);
+            if (seen >= target) {
+                return static_cast<int64_t>(std::min(bucketHighest(i), _max.load(std::memory_order_relaxed)));
+            }
+        }
+        return max();
+    }
+
+    // One table row in microseconds; pair with printPercentileHeader()
+    static void printPercentileHeader(FILE* out = stdout)
+    {
+        std::fprintf(out, "  %-22s %10s %10s", "(us)", "count", "min");
+        for (double p : Percentiles) {
+            char label[16];
+            std::snprintf(label, sizeof(label), "p%g", p);
+            std::fprintf(out, " %10s", label);
+        }
+        std::fprintf(out, " %10s\n", "max");
+    }
+
+    void printPercentileRow(const char* label, FILE* out = stdout) const
+    {
+        std::fprintf(out, "  %-22s %10" PRIu64 " %10.1f", label, count(), min() / 1000.0);
+        for (double p : Percentiles) {
+            std::fprintf(out, " %10.1f", valueAtPercentile(p) / 1000.0);
+        }
+        std::fprintf(out, " %10.1f\n", max() / 1000.0);
+    }
+
+    // Text block: header, one "<bucket lower bound ns> <count>" line per
+    // non-empty bucket, "end". Several blocks may share one file.
+    bool save(FILE* out, const std::string& name) const
+    {
+        std::fprintf(out, "histogram %s %u %u\n", name.c_str(), SubBucketBits, MaxValueBits);
+        std::fprintf(out, "summary %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n",
+                     count(), _sum.load(std::memory_order_relaxed),
+                     static_cast<uint64_t>(min()), _max.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < NumBuckets; ++i) {
+            uint64_t n = _counts[i].load(std::memory_order_relaxed);
+            if (n != 0) std::fprintf(out, "%" PRIu64 " %" PRIu64 "\n", bucketLowest(i), n);
+        }
+        return std::fprintf(out, "end\n") > 0;
+    }
+
+    // Reads the next block written by save() and merges it into this
+    // histogram. Returns false at end of file or on a malformed or
+    // differently bucketed block.
+    bool load(FILE* in, std::string* name = nullptr)
+    {
+        char nameBuf[128];
+        unsigned subBits, maxBits;
+        if (std::fscanf(in, " histogram %127s %u %u", nameBuf, &subBits, &maxBits) != 3) return false;
+        if (subBits != SubBucketBits || maxBits != MaxValueBits) return false;
+
+        uint64_t total, sum, minValue, maxValue;
+        if (std::fscanf(in, " summary %" SCNu64 " %" SCNu64 " %" SCNu64 " %" SCNu64,
+                        &total, &sum, &minValue, &maxValue) != 4) {
+            return false;
+        }
+
+        char token[32];
+        while (std::fscanf(in, " %31s", token) == 1 && std::strcmp(token, "end") != 0) {
+            uint64_t lowest, n;
+            if (std::sscanf(token, "%" SCNu64, &lowest) != 1 || std::fscanf(in, " %" SCNu64, &n) != 1) {
+                return false;
+            }
+            _counts[bucketIndex(lowest)].fetch_add(n, std::memory_order_relaxed);
+        }
+
+        _total.fetch_add(total, std::memory_order_relaxed);
+        _sum.fetch_add(sum, std::memory_order_relaxed);
+        if (total != 0) {
+            _raise(_max, maxValue);
+            _lower(_min, minValue);
+        }
+        if (name != nullptr) *name = nameBuf;
+        return true;
+    }
+
+    static constexpr size_t bucketIndex(uint64_t value)
+    {
+        constexpr uint64_t SubBuckets = uint64_t{1} << SubBucketBits;
+        if (value < SubBuckets) return static_cast<size_t>(value);
+        if (value >= (uint64_t{1} << MaxValueBits)) return NumBuckets - 1;
+
+        unsigned exponent = std::bit_width(value) - 1;
+        unsigned shift = exponent - SubBucketBits;
+        return (size_t{shift + 1} << SubBucketBits) + static_cast<size_t>((value >> shift) - SubBuckets);
+    }
+
+    static constexpr uint64_t bucketLowest(size_t index)
+    {
+        constexpr uint64_t SubBuckets = uint64_t{1} << SubBucketBits;
+        size_t octave = index >> SubBucketBits;
+        if (octave == 0) return index;
+        return (SubBuckets + (index & (SubBuckets - 1))) << (octave - 1);
+    }
+
+    static constexpr uint64_t bucketHighest(size_t index)
+    {
+        size_t octave = index >> SubBucketBits;
+        return bucketLowest(index) + (octave == 0 ? 0 : (uint64_t{1} << (octave - 1)) - 1);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, NumBuckets> _counts{};
+    std::atomic<uint64_t> _total{0};
+    std::atomic<uint64_t> _sum{0};
+    std::atomic<uint64_t> _max{0};
+    std::atomic<uint64_t> _min{std::numeric_limits<uint64_t>::max()};
+
+    static void _raise(std::atomic<uint64_t>& bound, uint64_t value) noexcept
+    {
+        uint64_t current = bound.load(std::memory_order_relaxed);
+        while (value > current && !bound.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    static void _lower(std::atomic<uint64_t>& bound, uint64_t value) noexcept
+    {
+        uint64_t current = bound.load(std::memory_order_relaxed);
+        while (value < current && !bound.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+};
+
+static_assert(LatencyHistogram::bucketIndex(63) == 63);
+static_assert(LatencyHistogram::bucketIndex(64) == 64);
+static_assert(LatencyHistogram::bucketLowest(LatencyHistogram::bucketIndex(1000003)) <= 1000003);
+static_assert(LatencyHistogram::bucketHighest(LatencyHistogram::bucketIndex(1000003)) >= 1000003);
+static_assert(LatencyHistogram::bucketIndex((uint64_t{1} << LatencyHistogram::MaxValueBits) - 1)
+              == LatencyHistogram::NumBuckets - 1);
@@ -0,0 +1,59 @@
+/*
+ * Release-path latency, split by stage. For every job released by a timer
+ * the release path is timestamped at
+ *   expiry   the scheduled release instant (when the timer should fire)
+ *   handler  the releasing thread runs (dispatcher / SIGEV_THREAD helper)
+ *   post     just before the release is posted to the service
+ *   wake     the service thread returns from its wait
+ *   run      the job body is entered
+ * and each gap goes into its own histogram, so a start-jitter regression
+ * can be pinned on the timer, the release bookkeeping, the IPC primitive
+ * plus scheduler wakeup, or the service's own prologue.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include "LatencyHistogram.hpp"
+
+struct ReleaseStages
+{
+    using time_point = std::chrono::steady_clock::time_point;
+
+    LatencyHistogram expiryToHandler;
+    LatencyHistogram handlerToPost;
+    LatencyHistogram postToWake;
+    LatencyHistogram wakeToRun;
+
+    void record(time_point expiry, time_point handler, time_point post, time_point wake, time_point run) noexcept
+    {
+        expiryToHandler.record(_ns(handler - expiry));
+        handlerToPost.record(_ns(post - handler));
+        postToWake.record(_ns(wake - post));
+        wakeToRun.record(_ns(run - wake));
+    }
+
+    void merge(const ReleaseStages& other) noexcept
+    {
+        expiryToHandler.merge(other.expiryToHandler);
+        handlerToPost.merge(other.handlerToPost);
+        postToWake.merge(other.postToWake);
+        wakeToRun.merge(other.wakeToRun);
+    }
+
+    // Rows for a LatencyHistogram percentile table
+    void printRows(FILE* out = stdout) const
+    {
+        expiryToHandler.printPercentileRow("expiry -> handler", out);
+        handlerToPost.printPercentileRow("handler -> post", out);
+        postToWake.printPercentileRow("post -> wake", out);
+        wakeToRun.printPercentileRow("wake -> run", out);
+    }
+
+private:
+    static int64_t _ns(std::chrono::steady_clock::duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    }
+};
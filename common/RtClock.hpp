@@ -0,0 +1,260 @@
+/*
+ * Low-overhead timestamps for service statistics and tracing.
+ *
+ * RtClock::now() returns a steady_clock::time_point (CLOCK_MONOTONIC domain,
+ * so it mixes freely with clock_nanosleep and steady_clock), but computes it
+ * from the CPU cycle counter instead of clock_gettime():
+ *   x86-64  - invariant TSC (rdtsc), used only if CPUID reports it
+ *   aarch64 - generic timer virtual count (CNTVCT_EL0)
+ * The counter is calibrated against CLOCK_MONOTONIC by init(), and
+ * verifyIfDue() re-checks it periodically. Small drift (e.g. NTP slewing
+ * CLOCK_MONOTONIC) re-bases the calibration without a step: the rate is
+ * re-measured and the error slewed out over the next second, so now()
+ * never goes backwards. A counter that jumps backwards or changes rate is
+ * abandoned and now() falls back to steady_clock for the rest of the run.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <time.h>
+#include "SeqLock.hpp"
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+class RtClock
+{
+public:
+    using duration = std::chrono::steady_clock::duration;
+    using time_point = std::chrono::steady_clock::time_point;
+
+    // Largest counter vs. CLOCK_MONOTONIC error tolerated before re-basing
+    static constexpr int64_t MaxErrorNs = 2000;
+
+    // Largest rate change between calibrations before the counter is abandoned
+    static constexpr int64_t MaxRateChangePpm = 500;
+
+    // A re-base absorbs the error over SlewNs, at most MaxSlewPpm faster
+    // or slower than the measured rate
+    static constexpr int64_t SlewNs = 1000000000;
+    static constexpr int64_t MaxSlewPpm = 200;
+
+    static time_point now() noexcept
+    {
+        if (!_counting.load(std::memory_order_acquire)) {
+            return std::chrono::steady_clock::now();
+        }
+        return time_point(duration(_calibration.load().toNs(_readCounter())));
+    }
+
+    // Calibrate once (about 20 ms); safe to call from several places
+    static void init()
+    {
+        std::call_once(_initOnce, [] {
+            std::lock_guard<std::mutex> lock(_calibrationMutex);
+            _calibrate();
+        });
+    }
+
+    // Cheap unless a check is due (at most once per interval, one caller wins)
+    static void verifyIfDue(std::chrono::nanoseconds interval = std::chrono::seconds(1))
+    {
+        int64_t nowNs = _monotonicNs();
+        int64_t due = _nextVerifyNs.load(std::memory_order_relaxed);
+        if (nowNs < due) return;
+        if (!_nextVerifyNs.compare_exchange_strong(due, nowNs + interval.count())) return;
+        verify();
+    }
+
+    // Compare the counter against CLOCK_MONOTONIC now. Returns false once the
+    // counter has been abandoned (or was never usable).
+    static bool verify()
+    {
+        std::lock_guard<std::mutex> lock(_calibrationMutex);
+        if (!usingCounter()) return false;
+        const Calibration cal = _calibration.load();
+
+        Sample sample = _sample();
+        int64_t error = cal.toNs(sample.counter) - sample.ns;
+        if (error > -MaxErrorNs && error < MaxErrorNs) return true;
+
+        // Re-measure the rate over the whole interval since the last sample
+        // it was measured against
+        if (sample.counter <= _anchor.counter || sample.ns <= _anchor.ns) {
+            _abandon();
+            return false;
+        }
+        uint64_t mult = _multiplier(sample.counter - _anchor.counter, sample.ns - _anchor.ns);
+        int64_t change = (static_cast<int64_t>(mult) - static_cast<int64_t>(_rate)) * 1000000
+                         / static_cast<int64_t>(_rate);
+        if (change > MaxRateChangePpm || change < -MaxRateChangePpm) {
+            _abandon();
+            return false;
+        }
+
+        // Continue from the time now() returns at this counter value and
+        // run slower (or faster) until the error is gone, instead of
+        // stepping back (or forward) by it
+        int64_t slew = std::clamp<int64_t>(error, -SlewNs / 1000000 * MaxSlewPpm, SlewNs / 1000000 * MaxSlewPpm);
+        auto slewed = static_cast<uint64_t>(static_cast<Int128>(mult) * (SlewNs - slew) / SlewNs);
+        _anchor = sample;
+        _rate = mult;
+        _publish(Calibration{sample.counter, cal.toNs(sample.counter), slewed});
+        _rebases.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    static bool usingCounter()
+    {
+        return _counting.load(std::memory_order_acquire);
+    }
+
+    static const char* sourceName()
+    {
+        if (!usingCounter()) return "clock_gettime(CLOCK_MONOTONIC)";
+#if defined(__x86_64__)
+        return "invariant TSC";
+#else
+        return "CNTVCT_EL0";
+#endif
+    }
+
+    // Calibrated counter frequency, 0 when not using the counter
+    static double counterHz()
+    {
+        if (!usingCounter()) return 0.0;
+        return 1e9 * static_cast<double>(uint64_t{1} << Shift) / _calibration.load().mult;
+    }
+
+    static uint64_t rebaseCount()
+    {
+        return _rebases.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr unsigned Shift = 32;
+
+    __extension__ typedef __int128 Int128;
+
+    // ns = baseNs + (counter - baseCounter) * mult >> Shift
+    struct Calibration
+    {
+        uint64_t baseCounter;
+        int64_t baseNs;
+        uint64_t mult;
+
+        int64_t toNs(uint64_t counter) const
+        {
+            auto ticks = static_cast<int64_t>(counter - baseCounter);
+            return baseNs + static_cast<int64_t>((static_cast<Int128>(ticks) * mult) >> Shift);
+        }
+    };
+
+    struct Sample
+    {
+        uint64_t counter;
+        int64_t ns;
+    };
+
+    // Written under _calibrationMutex; readers retry across a re-base
+    // instead of reading a slot that is being rewritten
+    static inline SeqLock<Calibration> _calibration;
+    static inline std::atomic<bool> _counting{false};
+    static inline std::atomic<int64_t> _nextVerifyNs{0};
+    static inline std::atomic<uint64_t> _rebases{0};
+    static inline std::mutex _calibrationMutex;
+    static inline Sample _anchor{0, 0};   // last counter/monotonic pair, under the mutex
+    static inline uint64_t _rate{0};      // unslewed multiplier measured up to _anchor
+    static inline std::once_flag _initOnce;
+
+    static uint64_t _readCounter() noexcept
+    {
+#if defined(__x86_64__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(value) :: "memory");
+        return value;
+#else
+        return 0;
+#endif
+    }
+
+    static bool _counterUsable()
+    {
+#if defined(__x86_64__)
+        // CPUID 0x80000007 EDX bit 8: invariant TSC (constant rate, runs in C-states)
+        unsigned eax, ebx, ecx, edx;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+        return (edx & (1u << 8)) != 0;
+#elif defined(__aarch64__)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static int64_t _monotonicNs()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+    // Counter/monotonic pair from the tightest of a few bracketed reads
+    static Sample _sample()
+    {
+        Sample best{0, 0};
+        int64_t bestWindow = INT64_MAX;
+        for (int i = 0; i < 16; ++i) {
+            int64_t before = _monotonicNs();
+            uint64_t counter = _readCounter();
+            int64_t after = _monotonicNs();
+            if (after - before < bestWindow) {
+                bestWindow = after - before;
+                best = Sample{counter, before + (after - before) / 2};
+            }
+        }
+        return best;
+    }
+
+    static uint64_t _multiplier(uint64_t ticks, int64_t ns)
+    {
+        return static_cast<uint64_t>((static_cast<Int128>(ns) << Shift) / ticks);
+    }
+
+    static void _publish(const Calibration& cal)
+    {
+        _calibration.store(cal);
+        _counting.store(true, std::memory_order_release);
+    }
+
+    static void _abandon()
+    {
+        _counting.store(false, std::memory_order_release);
+    }
+
+    static void _calibrate()
+    {
+        if (!_counterUsable()) return;
+
+        Sample start = _sample();
+        timespec pause{0, 20000000};
+        while (nanosleep(&pause, &pause) != 0 && errno == EINTR) {}
+        Sample end = _sample();
+
+        if (end.counter <= start.counter || end.ns <= start.ns) return;
+        _anchor = end;
+        _rate = _multiplier(end.counter - start.counter, end.ns - start.ns);
+        _publish(Calibration{end.counter, end.ns, _rate});
+        _nextVerifyNs.store(end.ns + 1000000000, std::memory_order_relaxed);
+    }
+};
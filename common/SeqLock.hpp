@@ -0,0 +1,79 @@
+/*
+ * Single-writer sequence lock for publishing a small trivially copyable
+ * struct (service statistics) from a real-time thread.
+ *
+ * The writer never blocks and never waits for readers: store() bumps the
+ * sequence to odd, copies the value, and bumps it back to even. Readers
+ * copy the value and retry if the sequence was odd or changed meanwhile,
+ * so a snapshot is always consistent. The value is kept as relaxed atomic
+ * words so the concurrent copy is race-free.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied word by word");
+
+public:
+    SeqLock() = default;
+
+    explicit SeqLock(const T& value)
+    {
+        store(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    // Writer side: only one thread may call store()
+    void store(const T& value) noexcept
+    {
+        std::array<uint64_t, Words> words{};
+        std::memcpy(words.data(), &value, sizeof(T));
+
+        uint64_t sequence = _sequence.load(std::memory_order_relaxed);
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < Words; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Reader side: any thread, any number of readers. retries (optional)
+    // counts how often a concurrent store() forced a re-read.
+    T load(uint64_t* retries = nullptr) const noexcept
+    {
+        std::array<uint64_t, Words> words;
+        while (true) {
+            uint64_t before = _sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                for (size_t i = 0; i < Words; ++i) {
+                    words[i] = _words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == before) break;
+            }
+            if (retries != nullptr) ++*retries;
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+private:
+    static constexpr size_t Words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> _sequence{0};
+    std::array<std::atomic<uint64_t>, Words> _words{};
+};
@@ -0,0 +1,384 @@
+/*
+ * Per-job trace recorder.
+ *
+ * Every service thread owns a TraceRing: a preallocated single-producer /
+ * single-consumer ring of JobEvent records (scheduled release, start, end,
+ * core, flags). push() is a handful of plain stores and one release store,
+ * never allocates, and drops (and counts) the event when the ring is full
+ * rather than blocking the job.
+ *
+ * A TraceRecorder drains all rings on one SCHED_OTHER thread and streams
+ * the events to a compact file. Each event is stored relative to the
+ * previous event of the same service (zigzag varints), so a periodic job
+ * with steady timing costs a few bytes. The file is rotated at maxFileBytes
+ * and only keepFiles files are kept (path, path.1, ...), so a 24 h run has
+ * a fixed disk footprint. Every file starts from a clean delta state and
+ * decodes on its own with TraceReader (see exer4redo/trace_decode.cpp).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syslog.h>
+
+struct JobEvent
+{
+    enum Flags : uint32_t {
+        DeadlineMiss  = 1u << 0,   // completed after its deadline (release + D)
+        SelfTimed     = 1u << 1,   // released by sleep-then-spin, not the dispatcher
+        MissedRelease = 1u << 2,   // releases were missed before this job (overrun)
+    };
+
+    int64_t releaseNs;   // scheduled release, CLOCK_MONOTONIC ns
+    int64_t startNs;     // job body entered
+    int64_t endNs;       // job body returned
+    uint16_t service;    // TraceRing id
+    uint16_t core;       // CPU the job ran on
+    uint32_t flags;
+};
+
+class TraceRing
+{
+public:
+    // capacity is rounded up to a power of two
+    TraceRing(uint16_t id, size_t capacity) :
+        _id(id),
+        _mask(std::bit_ceil(capacity) - 1),
+        _events(std::make_unique<JobEvent[]>(_mask + 1))
+    {
+    }
+
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    uint16_t id() const { return _id; }
+
+    // Producer side (the service thread only)
+    bool push(const JobEvent& event) noexcept
+    {
+        uint64_t head = _head.load(std::memory_order_relaxed);
+        if (head - _cachedTail > _mask) {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head - _cachedTail > _mask) {
+                _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        _events[head & _mask] = event;
+        _events[head & _mask].service = _id;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side (the drain thread only): calls sink(event) for every
+    // event available now and returns how many were consumed
+    template <typename Sink>
+    size_t drain(Sink&& sink)
+    {
+        uint64_t tail = _tail.load(std::memory_order_relaxed);
+        uint64_t head = _head.load(std::memory_order_acquire);
+        for (uint64_t i = tail; i != head; ++i) {
+            sink(_events[i & _mask]);
+        }
+        _tail.store(head, std::memory_order_release);
+        return static_cast<size_t>(head - tail);
+    }
+
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    uint16_t _id;
+    uint64_t _mask;
+    std::unique_ptr<JobEvent[]> _events;
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<uint64_t> _head{0};
+    uint64_t _cachedTail{0};
+    std::atomic<uint64_t> _dropped{0};
+    alignas(64) std::atomic<uint64_t> _tail{0};
+};
+
+// File format: "RTTRACE1", then records. Each record starts with a varint
+// tag = ring id << 1 | kind:
+//   kind 0 (event): zigzag(release - previous release of this ring),
+//                   zigzag(start - release), zigzag(end - start), core, flags
+//   kind 1 (drops): number of events the ring dropped since the last marker
+class TraceEncoding
+{
+public:
+    static constexpr char Magic[8] = {'R', 'T', 'T', 'R', 'A', 'C', 'E', '1'};
+
+    static size_t putVarint(uint8_t* out, uint64_t value)
+    {
+        size_t n = 0;
+        while (value >= 0x80) {
+            out[n++] = static_cast<uint8_t>(value) | 0x80;
+            value >>= 7;
+        }
+        out[n++] = static_cast<uint8_t>(value);
+        return n;
+    }
+
+    static uint64_t zigzag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+};
+
+class TraceRecorder
+{
+public:
+    struct Config
+    {
+        size_t ringCapacity = 4096;                       // events per service
+        size_t maxFileBytes = 64u << 20;                  // rotate after this
+        unsigned keepFiles = 4;                           // path, path.1, ...
+        std::chrono::milliseconds drainInterval{20};
+        int cpu = -1;                                     // drain thread affinity
+    };
+
+    TraceRecorder(std::string path, Config config) :
+        _path(std::move(path)),
+        _config(config)
+    {
+    }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    ~TraceRecorder()
+    {
+        stop();
+    }
+
+    // All rings must be added before start()
+    TraceRing& addRing()
+    {
+        _rings.push_back(std::make_unique<TraceRing>(static_cast<uint16_t>(_rings.size()), _config.ringCapacity));
+        return *_rings.back();
+    }
+
+    bool start()
+    {
+        if (!_openFile()) return false;
+        _lastRelease.assign(_rings.size(), 0);
+        _reportedDrops.assign(_rings.size(), 0);
+        _thread = std::jthread([this](std::stop_token stopToken) { _drainLoop(stopToken); });
+        return true;
+    }
+
+    // Drains whatever is left and closes the file
+    void stop()
+    {
+        if (_thread.joinable()) {
+            _thread.request_stop();
+            _thread.join();
+        }
+        if (_file != nullptr) {
+            _drainAll();
+            fclose(_file);
+            _file = nullptr;
+        }
+    }
+
+    uint64_t eventsWritten() const { return _eventsWritten.load(std::memory_order_relaxed); }
+    uint64_t bytesWritten() const { return _bytesWritten.load(std::memory_order_relaxed); }
+    uint64_t rotations() const { return _rotations.load(std::memory_order_relaxed); }
+
+    uint64_t eventsDropped() const
+    {
+        uint64_t dropped = 0;
+        for (const auto& ring : _rings) dropped += ring->dropped();
+        return dropped;
+    }
+
+private:
+    std::string _path;
+    Config _config;
+    std::vector<std::unique_ptr<TraceRing>> _rings;
+    std::jthread _thread;
+
+    // Drain thread state
+    FILE* _file{nullptr};
+    size_t _fileBytes{0};
+    std::vector<int64_t> _lastRelease;
+    std::vector<uint64_t> _reportedDrops;
+    std::atomic<uint64_t> _eventsWritten{0};
+    std::atomic<uint64_t> _bytesWritten{0};
+    std::atomic<uint64_t> _rotations{0};
+
+    bool _openFile()
+    {
+        _file = fopen(_path.c_str(), "wb");
+        if (_file == nullptr) {
+            syslog(LOG_ERR, "Failed to open trace file %s: %s", _path.c_str(), strerror(errno));
+            return false;
+        }
+        setvbuf(_file, nullptr, _IOFBF, 1 << 16);
+        fwrite(TraceEncoding::Magic, 1, sizeof(TraceEncoding::Magic), _file);
+        _fileBytes = sizeof(TraceEncoding::Magic);
+        std::fill(_lastRelease.begin(), _lastRelease.end(), 0);
+        return true;
+    }
+
+    // path.(keep-2) -> path.(keep-1), ..., path -> path.1, then a fresh path
+    void _rotate()
+    {
+        fclose(_file);
+        _file = nullptr;
+        for (unsigned i = _config.keepFiles - 1; i > 0; --i) {
+            std::string from = i == 1 ? _path : _path + "." + std::to_string(i - 1);
+            std::string to = _path + "." + std::to_string(i);
+            rename(from.c_str(), to.c_str());
+        }
+        if (_config.keepFiles <= 1) remove(_path.c_str());
+        _rotations.fetch_add(1, std::memory_order_relaxed);
+        _openFile();
+    }
+
+    void _write(const uint8_t* data, size_t size)
+    {
+        if (_file == nullptr) return;
+        fwrite(data, 1, size, _file);
+        _fileBytes += size;
+        _bytesWritten.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void _writeEvent(const JobEvent& event)
+    {
+        uint8_t record[5 * 10 + 10];
+        size_t n = TraceEncoding::putVarint(record, uint64_t{event.service} << 1);
+        n += TraceEncoding::putVarint(record + n, TraceEncoding::zigzag(event.releaseNs - _lastRelease[event.service]));
+        n += TraceEncoding::putVarint(record + n, TraceEncoding::zigzag(event.startNs - event.releaseNs));
+        n += TraceEncoding::putVarint(record + n, TraceEncoding::zigzag(event.endNs - event.startNs));
+        n += TraceEncoding::putVarint(record + n, event.core);
+        n += TraceEncoding::putVarint(record + n, event.flags);
+        _lastRelease[event.service] = event.releaseNs;
+        _write(record, n);
+        _eventsWritten.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void _writeDrops(uint16_t ring, uint64_t count)
+    {
+        uint8_t record[20];
+        size_t n = TraceEncoding::putVarint(record, (uint64_t{ring} << 1) | 1);
+        n += TraceEncoding::putVarint(record + n, count);
+        _write(record, n);
+    }
+
+    void _drainAll()
+    {
+        for (auto& ring : _rings) {
+            ring->drain([this](const JobEvent& event) {
+                if (_fileBytes >= _config.maxFileBytes) _rotate();
+                _writeEvent(event);
+            });
+
+            uint64_t dropped = ring->dropped();
+            if (dropped != _reportedDrops[ring->id()]) {
+                _writeDrops(ring->id(), dropped - _reportedDrops[ring->id()]);
+                _reportedDrops[ring->id()] = dropped;
+            }
+        }
+        if (_file != nullptr) fflush(_file);
+    }
+
+    void _drainLoop(std::stop_token stopToken)
+    {
+        if (_config.cpu >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(_config.cpu, &cpuset);
+            int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+            if (result != 0) {
+                syslog(LOG_ERR, "Failed to set trace drain affinity: %s", strerror(result));
+            }
+        }
+
+        while (!stopToken.stop_requested()) {
+            std::this_thread::sleep_for(_config.drainInterval);
+            _drainAll();
+        }
+    }
+};
+
+// Sequential decoder for one trace file
+class TraceReader
+{
+public:
+    enum class Record { Event, Drops, End, Error };
+
+    explicit TraceReader(FILE* in) :
+        _in(in)
+    {
+        char magic[sizeof(TraceEncoding::Magic)];
+        _valid = fread(magic, 1, sizeof(magic), in) == sizeof(magic)
+                 && std::memcmp(magic, TraceEncoding::Magic, sizeof(magic)) == 0;
+    }
+
+    bool valid() const { return _valid; }
+
+    // Event: fills event. Drops: fills event.service and dropped.
+    Record next(JobEvent& event, uint64_t& dropped)
+    {
+        if (!_valid) return Record::Error;
+
+        uint64_t tag;
+        if (!_getVarint(tag)) return feof(_in) ? Record::End : Record::Error;
+        auto ring = static_cast<uint16_t>(tag >> 1);
+        event.service = ring;
+        if (tag & 1) {
+            return _getVarint(dropped) ? Record::Drops : Record::Error;
+        }
+
+        uint64_t release, start, end, core, flags;
+        if (!_getVarint(release) || !_getVarint(start) || !_getVarint(end) || !_getVarint(core) || !_getVarint(flags)) {
+            return Record::Error;
+        }
+        if (ring >= _lastRelease.size()) _lastRelease.resize(ring + 1, 0);
+        event.releaseNs = _lastRelease[ring] + TraceEncoding::unzigzag(release);
+        event.startNs = event.releaseNs + TraceEncoding::unzigzag(start);
+        event.endNs = event.startNs + TraceEncoding::unzigzag(end);
+        event.core = static_cast<uint16_t>(core);
+        event.flags = static_cast<uint32_t>(flags);
+        _lastRelease[ring] = event.releaseNs;
+        return Record::Event;
+    }
+
+private:
+    FILE* _in;
+    bool _valid{false};
+    std::vector<int64_t> _lastRelease;
+
+    bool _getVarint(uint64_t& value)
+    {
+        value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            int c = fgetc(_in);
+            if (c == EOF) return false;
+            value |= static_cast<uint64_t>(c & 0x7f) << shift;
+            if ((c & 0x80) == 0) return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,200 @@
+/*
+ * Compile-time cyclic executive.
+ *
+ * The release table for one hyperperiod is generated by the compiler from a
+ * list of periodic services, e.g. the lab1 Fib10/Fib20 schedule:
+ *
+ *   using Lab1 = CyclicSchedule<100'000,            // max hyperperiod (us)
+ *                               Periodic<20'000>,   // Fib10, 20 ms
+ *                               Periodic<50'000>>;  // Fib20, 50 ms
+ *
+ * gives Lab1::Table = {0:{0,1}, 20ms:{0}, 40ms:{0}, 50ms:{1}, 60ms:{0}, 80ms:{0}}.
+ * A schedule whose hyperperiod exceeds the configured limit does not compile.
+ *
+ * CyclicExecutive replays the table on one thread with absolute-time sleeps
+ * (clock_nanosleep TIMER_ABSTIME on CLOCK_MONOTONIC), so releases do not
+ * drift the way chained relative delays (taskDelay) do, and no scheduling
+ * decision is made at runtime.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syslog.h>
+#include <time.h>
+
+// One service in a cyclic schedule: released at OffsetUs + k * PeriodUs
+template <uint64_t PeriodUs, uint64_t OffsetUs = 0>
+struct Periodic
+{
+    static_assert(PeriodUs > 0, "period must be positive");
+    static_assert(OffsetUs < PeriodUs, "offset must be less than the period");
+
+    static constexpr uint64_t period = PeriodUs;
+    static constexpr uint64_t offset = OffsetUs;
+};
+
+template <uint64_t MaxHyperperiodUs, typename... Services>
+class CyclicSchedule
+{
+public:
+    static constexpr size_t NumServices = sizeof...(Services);
+    static_assert(NumServices > 0, "a schedule needs at least one service");
+    static_assert(NumServices <= 64, "release masks hold at most 64 services");
+
+    static constexpr uint64_t Hyperperiod = [] {
+        uint64_t h = 1;
+        for (uint64_t p : {Services::period...}) {
+            h = std::lcm(h, p);
+            if (h > MaxHyperperiodUs) break;
+        }
+        return h;
+    }();
+    static_assert(Hyperperiod <= MaxHyperperiodUs,
+                  "hyperperiod of the service periods exceeds the configured limit");
+
+    // All services released at the same instant share one frame
+    struct Frame
+    {
+        uint64_t offsetUs;      // from the start of the hyperperiod
+        uint64_t releaseMask;   // bit i = release service i
+    };
+
+private:
+    static constexpr std::array<uint64_t, NumServices> periods{Services::period...};
+    static constexpr std::array<uint64_t, NumServices> offsets{Services::offset...};
+
+    // First release instant strictly after t (or at t when inclusive)
+    static constexpr uint64_t nextRelease(uint64_t t, bool inclusive)
+    {
+        uint64_t next = Hyperperiod;
+        for (size_t i = 0; i < NumServices; ++i) {
+            uint64_t r = offsets[i];
+            if (r < t || (r == t && !inclusive)) {
+                r += ((t - r) / periods[i] + 1) * periods[i];
+            }
+            next = std::min(next, r);
+        }
+        return next;
+    }
+
+    static constexpr uint64_t maskAt(uint64_t t)
+    {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < NumServices; ++i) {
+            if (t >= offsets[i] && (t - offsets[i]) % periods[i] == 0) {
+                mask |= uint64_t{1} << i;
+            }
+        }
+        return mask;
+    }
+
+    static constexpr size_t countFrames()
+    {
+        size_t n = 0;
+        for (uint64_t t = nextRelease(0, true); t < Hyperperiod; t = nextRelease(t, false)) {
+            ++n;
+        }
+        return n;
+    }
+
+public:
+    static constexpr size_t NumFrames = countFrames();
+
+    static constexpr std::array<Frame, NumFrames> Table = [] {
+        std::array<Frame, NumFrames> table{};
+        size_t n = 0;
+        for (uint64_t t = nextRelease(0, true); t < Hyperperiod; t = nextRelease(t, false)) {
+            table[n++] = Frame{t, maskAt(t)};
+        }
+        return table;
+    }();
+};
+
+// Replays a CyclicSchedule forever (until stopped). Release is called as
+// release(serviceIndex, scheduledReleaseTime) for every bit of every frame.
+template <typename Schedule, typename Release>
+class CyclicExecutive
+{
+public:
+    explicit CyclicExecutive(Release release, int affinity = -1) :
+        _release(std::move(release)),
+        _affinity(affinity)
+    {
+    }
+
+    // Hyperperiod k starts at epoch + k * Schedule::Hyperperiod
+    void start(std::chrono::steady_clock::time_point epoch)
+    {
+        _epoch = epoch;
+        _thread = std::jthread([this](std::stop_token stopToken) { _run(stopToken); });
+    }
+
+    void stop()
+    {
+        if (_thread.joinable()) {
+            _thread.request_stop();
+            _thread.join();
+        }
+    }
+
+    uint64_t framesDispatched() const { return _frames.load(std::memory_order_relaxed); }
+
+private:
+    Release _release;
+    int _affinity;
+    std::chrono::steady_clock::time_point _epoch;
+    std::atomic<uint64_t> _frames{0};
+    std::jthread _thread;
+
+    void _run(std::stop_token stopToken)
+    {
+        if (_affinity >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(_affinity, &cpuset);
+            int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+            if (result != 0) {
+                syslog(LOG_ERR, "Failed to set cyclic executive affinity: %s", strerror(result));
+            }
+        }
+
+        struct sched_param param;
+        param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (result != 0) {
+            syslog(LOG_ERR, "Failed to set cyclic executive scheduling parameters: %s", strerror(result));
+        }
+
+        auto cycleStart = _epoch;
+        while (!stopToken.stop_requested()) {
+            for (const auto& frame : Schedule::Table) {
+                auto scheduled = cycleStart + std::chrono::microseconds(frame.offsetUs);
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(scheduled.time_since_epoch()).count();
+                timespec wakeup{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR) {}
+
+                if (stopToken.stop_requested()) return;
+
+                for (uint64_t mask = frame.releaseMask; mask != 0; mask &= mask - 1) {
+                    _release(static_cast<size_t>(std::countr_zero(mask)), scheduled);
+                }
+                _frames.fetch_add(1, std::memory_order_relaxed);
+            }
+            cycleStart += std::chrono::microseconds(Schedule::Hyperperiod);
+        }
+    }
+};
@@ -0,0 +1,133 @@
+/*
+ * EDF schedulability on one core, in integer ns, for the same TaskTiming
+ * sets as Schedulability.hpp (order does not matter here).
+ *
+ * Exact test by processor demand (Baruah, Rosier & Howell): a synchronous
+ * periodic set is EDF-feasible iff U <= 1 and at every absolute deadline
+ * t below L
+ *   h(t) = sum_{D_i <= t} (floor((t - D_i) / T_i) + 1) C_i  <=  t
+ * where L bounds the first busy period: the smaller of its length
+ *   w = sum_i ceil(w / T_i) C_i
+ * and, for U < 1, Zhang & Burns' La = max(max_i (D_i - T_i),
+ * sum_i (T_i - D_i) U_i / (1 - U)).
+ *
+ * Instead of every deadline below L, Quick Processor-demand Analysis
+ * (Zhang & Burns) walks t down from the last one: if h(t) < t no deadline
+ * in (h(t), t] can fail, so t jumps to h(t); otherwise to the previous
+ * deadline. It stops at a failure, or when h(t) <= min D_i (feasible).
+ *
+ * Release jitter shortens a task's effective deadline to D - J. Blocking
+ * (SRP critical sections) is taken pessimistically as the largest B added
+ * to h(t) at every t, and to the busy period.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "Schedulability.hpp"
+
+class EdfSchedulability
+{
+public:
+    // busyPeriodBound() when the first busy period did not close within
+    // MaxBusyPeriodSteps fixed-point steps (U ~ 1 with La unbounded)
+    static constexpr int64_t Unbounded = std::numeric_limits<int64_t>::max();
+    static constexpr int MaxBusyPeriodSteps = 1 << 20;
+
+    // h(t), plus the largest blocking term
+    static int64_t demand(const std::vector<TaskTiming>& tasks, int64_t t)
+    {
+        int64_t sum = _blocking(tasks);
+        for (const auto& task : tasks) {
+            int64_t deadline = _deadline(task);
+            if (deadline <= t) sum += ((t - deadline) / task.periodNs + 1) * task.wcetNs;
+        }
+        return sum;
+    }
+
+    // Largest absolute deadline strictly before t, 0 if there is none
+    static int64_t deadlineBefore(const std::vector<TaskTiming>& tasks, int64_t t)
+    {
+        int64_t latest = 0;
+        for (const auto& task : tasks) {
+            int64_t deadline = _deadline(task);
+            if (deadline < t) latest = std::max(latest, deadline + (t - 1 - deadline) / task.periodNs * task.periodNs);
+        }
+        return latest;
+    }
+
+    // L: no deadline at or after it needs checking
+    static int64_t busyPeriodBound(const std::vector<TaskTiming>& tasks)
+    {
+        const double utilization = Schedulability::utilization(tasks);
+        const int64_t blocking = _blocking(tasks);
+
+        // La, when U < 1 leaves it finite
+        int64_t bound = Unbounded;
+        if (Schedulability::compareUtilization(tasks, tasks.size()) < 0) {
+            double slack = static_cast<double>(blocking);
+            int64_t latest = 0;
+            for (const auto& task : tasks) {
+                slack += static_cast<double>(task.periodNs - _deadline(task)) * task.utilization();
+                latest = std::max(latest, _deadline(task) - task.periodNs);
+            }
+            double la = std::ceil(std::max(0.0, slack) / (1.0 - utilization));
+            if (la < 0x1p62) bound = std::max(latest, static_cast<int64_t>(la));
+        }
+
+        // Length of the synchronous busy period, cut short at La
+        int64_t w = blocking;
+        for (const auto& task : tasks) w += task.wcetNs;
+        for (int step = 0; step < MaxBusyPeriodSteps && w < bound; ++step) {
+            int64_t next = blocking;
+            for (const auto& task : tasks) next += (w + task.periodNs - 1) / task.periodNs * task.wcetNs;
+            if (next == w) return w;
+            w = next;
+        }
+        return bound;
+    }
+
+    // QPA; steps (optional) receives the number of h(t) evaluations
+    static bool feasible(const std::vector<TaskTiming>& tasks, int64_t* steps = nullptr)
+    {
+        if (steps != nullptr) *steps = 0;
+        if (tasks.empty()) return true;
+        if (Schedulability::compareUtilization(tasks, tasks.size()) > 0) return false;
+
+        int64_t smallest = Unbounded;
+        for (const auto& task : tasks) {
+            if (_deadline(task) < task.wcetNs) return false;
+            smallest = std::min(smallest, _deadline(task));
+        }
+
+        const int64_t bound = busyPeriodBound(tasks);
+        if (bound == Unbounded) return false;   // undecided: treat as infeasible
+
+        int64_t t = deadlineBefore(tasks, bound);
+        while (t > 0) {
+            int64_t h = demand(tasks, t);
+            if (steps != nullptr) ++*steps;
+            if (h > t) return false;
+            if (h <= smallest) return true;
+            t = h < t ? h : deadlineBefore(tasks, t);
+        }
+        return true;
+    }
+
+private:
+    static int64_t _deadline(const TaskTiming& task)
+    {
+        return task.deadline() - task.jitterNs;
+    }
+
+    static int64_t _blocking(const std::vector<TaskTiming>& tasks)
+    {
+        int64_t blocking = 0;
+        for (const auto& task : tasks) blocking = std::max(blocking, task.blockingNs);
+        return blocking;
+    }
+};
@@ -0,0 +1,298 @@
+/*
+ * Co-runners that interfere with the services the way co-located
+ * processes do, for jitter-under-contention tests:
+ *
+ *   llc        writes one word per cache line across 2x the last-level
+ *              cache, evicting the services' working sets
+ *   bandwidth  memcpy between two large buffers, saturating DRAM bandwidth
+ *   tlb        touches one word per 4 KiB page across 64 MiB (no huge
+ *              pages), so every access misses the TLB
+ *   syscall    back-to-back cheap system calls (kernel entry/exit, lock
+ *              and cache traffic in the kernel)
+ *   timer      a timerfd firing every 20 us, i.e. a stream of hrtimer
+ *              interrupts and wakeups on its core
+ *
+ * Each co-runner is a thread pinned to one CPU, by default SCHED_OTHER so
+ * it only takes what the real-time services leave; priority > 0 runs it
+ * SCHED_FIFO instead. Buffers are allocated and touched before the thread
+ * reports started, so start-up page faults are not part of the measurement.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+class CoRunner
+{
+public:
+    enum class Kind { LlcThrash, BandwidthHog, TlbThrash, SyscallStorm, TimerStorm };
+
+    static constexpr Kind Kinds[] = {
+        Kind::LlcThrash, Kind::BandwidthHog, Kind::TlbThrash, Kind::SyscallStorm, Kind::TimerStorm};
+
+    static const char* name(Kind kind)
+    {
+        switch (kind) {
+        case Kind::LlcThrash: return "llc";
+        case Kind::BandwidthHog: return "bandwidth";
+        case Kind::TlbThrash: return "tlb";
+        case Kind::SyscallStorm: return "syscall";
+        case Kind::TimerStorm: return "timer";
+        }
+        return "?";
+    }
+
+    // false if text names no co-runner
+    static bool parse(std::string_view text, Kind& kind)
+    {
+        for (Kind k : Kinds) {
+            if (text == name(k)) {
+                kind = k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // First SMT sibling of cpu, or -1 if it has none
+    static int siblingOf(int cpu)
+    {
+        std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list";
+        FILE* file = std::fopen(path.c_str(), "r");
+        if (file == nullptr) return -1;
+        char list[64] = {};
+        bool read = std::fgets(list, sizeof(list), file) != nullptr;
+        std::fclose(file);
+        if (!read) return -1;
+
+        // "0,4" or "0-1"
+        for (char* p = list; *p != '\0';) {
+            char* end;
+            long first = std::strtol(p, &end, 10);
+            if (end == p) break;
+            long last = first;
+            if (*end == '-') last = std::strtol(end + 1, &end, 10);
+            for (long c = first; c <= last; ++c) {
+                if (c != cpu) return static_cast<int>(c);
+            }
+            p = *end == ',' ? end + 1 : end;
+        }
+        return -1;
+    }
+
+    // Last-level cache size of cpu 0 in bytes, or fallback if unknown
+    static size_t lastLevelCacheBytes(size_t fallback = size_t{32} << 20)
+    {
+        size_t largest = 0;
+        for (int index = 0; index < 8; ++index) {
+            std::string path = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size";
+            FILE* file = std::fopen(path.c_str(), "r");
+            if (file == nullptr) break;
+            unsigned long size = 0;
+            char unit = 0;
+            if (std::fscanf(file, "%lu%c", &size, &unit) >= 1) {
+                if (unit == 'K') size <<= 10;
+                if (unit == 'M') size <<= 20;
+                largest = std::max<size_t>(largest, size);
+            }
+            std::fclose(file);
+        }
+        return largest > 0 ? largest : fallback;
+    }
+
+    CoRunner(Kind kind, int cpu, int priority = 0) : _kind(kind), _cpu(cpu), _priority(priority) {}
+
+    CoRunner(const CoRunner&) = delete;
+    CoRunner& operator=(const CoRunner&) = delete;
+
+    ~CoRunner()
+    {
+        stop();
+    }
+
+    Kind kind() const
+    {
+        return _kind;
+    }
+
+    int cpu() const
+    {
+        return _cpu;
+    }
+
+    // Returns once the co-runner's buffers are ready and it is interfering
+    void start()
+    {
+        _thread = std::jthread([this](std::stop_token stop) { _run(stop); });
+        while (!_started.load(std::memory_order_acquire)) std::this_thread::yield();
+    }
+
+    void stop()
+    {
+        if (_thread.joinable()) {
+            _thread.request_stop();
+            _thread.join();
+        }
+    }
+
+    // Work units done (lines, copies, pages, calls, timer expiries)
+    uint64_t operations() const
+    {
+        return _operations.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr size_t LineBytes = 64;
+    static constexpr size_t PageBytes = 4096;
+    static constexpr size_t TlbPages = 16384;                    // 64 MiB
+    static constexpr size_t BandwidthBytes = size_t{64} << 20;
+    static constexpr long TimerIntervalNs = 20000;
+
+    Kind _kind;
+    int _cpu;
+    int _priority;
+    std::jthread _thread;
+    std::atomic<bool> _started{false};
+    std::atomic<uint64_t> _operations{0};
+
+    void _pin()
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(_cpu, &cpuset);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+
+        struct sched_param param;
+        param.sched_priority = _priority;
+        pthread_setschedparam(pthread_self(), _priority > 0 ? SCHED_FIFO : SCHED_OTHER, &param);
+    }
+
+    void _run(std::stop_token stop)
+    {
+        _pin();
+        switch (_kind) {
+        case Kind::LlcThrash: _llcThrash(stop); break;
+        case Kind::BandwidthHog: _bandwidthHog(stop); break;
+        case Kind::TlbThrash: _tlbThrash(stop); break;
+        case Kind::SyscallStorm: _syscallStorm(stop); break;
+        case Kind::TimerStorm: _timerStorm(stop); break;
+        }
+        _started.store(true, std::memory_order_release);   // in case setup failed
+    }
+
+    // Operations are published in batches to keep the counter off the hot loop
+    void _count(uint64_t n)
+    {
+        _operations.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void _llcThrash(std::stop_token stop)
+    {
+        size_t bytes = std::clamp(2 * lastLevelCacheBytes(), size_t{8} << 20, size_t{512} << 20);
+        std::vector<uint64_t> buffer(bytes / sizeof(uint64_t), 1);
+        _started.store(true, std::memory_order_release);
+
+        // Odd line stride: walks every line, defeats the next-line prefetcher
+        const size_t lines = bytes / LineBytes;
+        const size_t stride = 1031;
+        size_t line = 0;
+        while (!stop.stop_requested()) {
+            for (size_t i = 0; i < 65536; ++i) {
+                buffer[line * (LineBytes / sizeof(uint64_t))]++;
+                line += stride;
+                if (line >= lines) line -= lines;
+            }
+            _count(65536);
+        }
+    }
+
+    void _bandwidthHog(std::stop_token stop)
+    {
+        std::vector<char> from(BandwidthBytes, 1);
+        std::vector<char> to(BandwidthBytes, 0);
+        _started.store(true, std::memory_order_release);
+
+        while (!stop.stop_requested()) {
+            std::memcpy(to.data(), from.data(), BandwidthBytes);
+            std::swap(from, to);
+            _count(1);
+        }
+    }
+
+    void _tlbThrash(std::stop_token stop)
+    {
+        size_t bytes = TlbPages * PageBytes;
+        void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED) {
+            std::perror("tlb co-runner mmap");
+            return;
+        }
+        madvise(mapping, bytes, MADV_NOHUGEPAGE);
+        auto* pages = static_cast<char*>(mapping);
+        for (size_t page = 0; page < TlbPages; ++page) pages[page * PageBytes] = 1;
+        _started.store(true, std::memory_order_release);
+
+        // Page-sized stride with a rotating line offset, so the accesses
+        // spread over the cache sets instead of all mapping to one
+        size_t offset = 0;
+        while (!stop.stop_requested()) {
+            for (size_t page = 0; page < TlbPages; page += 1) {
+                pages[page * PageBytes + offset]++;
+            }
+            offset = (offset + LineBytes) % PageBytes;
+            _count(TlbPages);
+        }
+        munmap(mapping, bytes);
+    }
+
+    void _syscallStorm(std::stop_token stop)
+    {
+        int devNull = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+        _started.store(true, std::memory_order_release);
+
+        char byte = 0;
+        while (!stop.stop_requested()) {
+            for (int i = 0; i < 1024; ++i) {
+                syscall(SYS_getppid);
+                ssize_t written = ::write(devNull, &byte, 1);
+                (void)written;
+            }
+            _count(2048);
+        }
+        if (devNull >= 0) ::close(devNull);
+    }
+
+    void _timerStorm(std::stop_token stop)
+    {
+        int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (fd < 0) {
+            std::perror("timer co-runner timerfd_create");
+            return;
+        }
+        itimerspec interval{{0, TimerIntervalNs}, {0, TimerIntervalNs}};
+        timerfd_settime(fd, 0, &interval, nullptr);
+        _started.store(true, std::memory_order_release);
+
+        uint64_t expirations;
+        while (!stop.stop_requested()) {
+            if (::read(fd, &expirations, sizeof(expirations)) == sizeof(expirations)) _count(expirations);
+        }
+        ::close(fd);
+    }
+};
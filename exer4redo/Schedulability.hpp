@@ -0,0 +1,657 @@
+/*
+ * Fixed-priority schedulability analysis for one core, in integer ns.
+ *
+ * A C++ replacement for exercise2/FeasibilityExampleCode/feasibility_tests.c,
+ * which only handles D = T and does its fixed point in double with ceil().
+ * Each task has a WCET C, period T, relative deadline D (any D, not just
+ * D = T), release jitter J and blocking B (longest lower-priority critical
+ * section). Task sets are given in priority order, index 0 highest.
+ * Overloads taking priorities (per task, non-increasing) allow ties:
+ * SCHED_FIFO does not preempt between equal priorities, so each task is
+ * analysed with all of its peers counted as higher priority.
+ *
+ * responseTime() is exact response-time analysis (Joseph & Pandya, with
+ * Tindell's extension for jitter and arbitrary deadlines): for each job q
+ * of the level-i busy period
+ *   w(q) = B + (q+1)C + sum_{j<i} ceil((w(q) + J_j) / T_j) C_j
+ *   R    = max_q  w(q) - qT + J
+ * iterated to a fixed point, stopping at the first job that ends the busy
+ * period, or as soon as a response exceeds D.
+ * schedulingPointFeasible() is the equivalent exact test over scheduling
+ * points, for D <= T without jitter.
+ * criticalScalingFactor() and maxWcet() give the margin behind a verdict;
+ * assignPriorities() finds a feasible priority order where one exists.
+ * The Liu & Layland and hyperbolic bounds are kept as the cheap sufficient
+ * tests; they are only meaningful for D = T, J = B = 0.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+struct TaskTiming
+{
+    int64_t wcetNs;
+    int64_t periodNs;
+    int64_t deadlineNs = 0;   // 0 = implicit deadline (D = T)
+    int64_t jitterNs = 0;
+    int64_t blockingNs = 0;
+
+    int64_t deadline() const
+    {
+        return deadlineNs > 0 ? deadlineNs : periodNs;
+    }
+
+    double utilization() const
+    {
+        return static_cast<double>(wcetNs) / static_cast<double>(periodNs);
+    }
+};
+
+class Schedulability
+{
+public:
+    // Response time of a task that can miss its deadline
+    static constexpr int64_t Unschedulable = std::numeric_limits<int64_t>::max();
+
+    // A busy period longer than this many jobs of the task under analysis
+    // (only possible for D > T at utilization ~1) is treated as unschedulable
+    static constexpr int64_t MaxBusyPeriodJobs = int64_t{1} << 16;
+
+    static double utilization(const std::vector<TaskTiming>& tasks)
+    {
+        double sum = 0.0;
+        for (const auto& task : tasks) sum += task.utilization();
+        return sum;
+    }
+
+    // Sign of U - 1 over tasks[0..count), exact: the double sum decides
+    // when it is further from 1 than its rounding, otherwise it is redone
+    // as a fraction in 128 bits. 0 both for U = 1 and for the rare sum the
+    // fraction overflows on (many coprime periods) that rounding leaves
+    // undecided, so 0 never rejects a set.
+    static int compareUtilization(const std::vector<TaskTiming>& tasks, size_t count)
+    {
+        double sum = 0.0;
+        for (size_t k = 0; k < count; ++k) sum += tasks[k].utilization();
+        const double tolerance = _utilizationTolerance(count);
+        if (sum > 1.0 + tolerance) return 1;
+        if (sum < 1.0 - tolerance) return -1;
+
+        Int128 numerator = 0, denominator = 1;
+        for (size_t k = 0; k < count; ++k) {
+            const Int128 period = tasks[k].periodNs;
+            const Int128 common = _gcd(denominator, period);
+            Int128 scaled, added, sumOf, product;
+            if (__builtin_mul_overflow(numerator, period / common, &scaled) ||
+                __builtin_mul_overflow(Int128{tasks[k].wcetNs}, denominator / common, &added) ||
+                __builtin_add_overflow(scaled, added, &sumOf) ||
+                __builtin_mul_overflow(denominator / common, period, &product)) {
+                return 0;
+            }
+            const Int128 reduce = _gcd(sumOf, product);
+            numerator = sumOf / reduce;
+            denominator = product / reduce;
+        }
+        return numerator > denominator ? 1 : numerator < denominator ? -1 : 0;
+    }
+
+    // U <= n (2^(1/n) - 1)
+    static bool liuLaylandBound(const std::vector<TaskTiming>& tasks)
+    {
+        if (tasks.empty()) return true;
+        double n = static_cast<double>(tasks.size());
+        return utilization(tasks) <= n * (std::pow(2.0, 1.0 / n) - 1.0);
+    }
+
+    // prod (U_i + 1) <= 2 (Bini, Buttazzo & Buttazzo)
+    static bool hyperbolicBound(const std::vector<TaskTiming>& tasks)
+    {
+        double product = 1.0;
+        for (const auto& task : tasks) product *= task.utilization() + 1.0;
+        return product <= 2.0;
+    }
+
+    // Worst-case response time of tasks[i], with tasks[0..i) at higher
+    // priority; Unschedulable if it can exceed its deadline.
+    // warmStart: a known lower bound on the completion of the first job,
+    // e.g. *firstJob from an earlier call with less interference, which
+    // saves most fixed-point iterations. firstJob (optional) receives that
+    // completion, or 0 if the analysis gave up before reaching it.
+    static int64_t responseTime(const std::vector<TaskTiming>& tasks, size_t i,
+                                int64_t warmStart = 0, int64_t* firstJob = nullptr)
+    {
+        const TaskTiming& task = tasks[i];
+        const int64_t deadline = task.deadline();
+        if (firstJob != nullptr) *firstJob = 0;
+        if (task.wcetNs + task.blockingNs + task.jitterNs > deadline) return Unschedulable;
+
+        int64_t higherWcet = 0;
+        for (size_t j = 0; j < i; ++j) higherWcet += tasks[j].wcetNs;
+        if (compareUtilization(tasks, i + 1) > 0) return Unschedulable;
+
+        int64_t worst = 0;
+        int64_t w = std::max(task.blockingNs + task.wcetNs + higherWcet, warmStart);   // lower bound for job 0
+        for (int64_t q = 0; q < MaxBusyPeriodJobs; ++q) {
+            // Fixed point for the completion of job q; w only grows
+            const int64_t own = task.blockingNs + (q + 1) * task.wcetNs;
+            const int64_t limit = deadline + q * task.periodNs - task.jitterNs;
+            while (true) {
+                int64_t next = own;
+                for (size_t j = 0; j < i; ++j) {
+                    next += _ceilDiv(w + tasks[j].jitterNs, tasks[j].periodNs) * tasks[j].wcetNs;
+                }
+                if (next > limit) return Unschedulable;
+                if (next == w) break;
+                w = next;
+            }
+
+            worst = std::max(worst, w - q * task.periodNs + task.jitterNs);
+            if (q == 0 && firstJob != nullptr) *firstJob = w;
+
+            // Job q completes before job q+1 is released: busy period over
+            if (w + task.jitterNs <= (q + 1) * task.periodNs) return worst;
+
+            w += task.wcetNs;   // job q+1 finishes at least one WCET later
+        }
+        return Unschedulable;
+    }
+
+    struct Analysis
+    {
+        bool feasible;
+        std::vector<int64_t> responseNs;   // per task, Unschedulable on a miss
+    };
+
+    // responseTime() of tasks[i] with the tasks that share its priority
+    // (priorities[k] for tasks[k]; empty = all distinct) counted as higher
+    // priority, since any of them may run ahead of it
+    static int64_t responseTime(const std::vector<TaskTiming>& tasks, size_t i, const std::vector<int>& priorities)
+    {
+        size_t end = i + 1;
+        while (!priorities.empty() && end < tasks.size() && priorities[end] == priorities[i]) ++end;
+        if (end == i + 1) return responseTime(tasks, i);
+
+        std::vector<TaskTiming> peers(tasks.begin(), tasks.begin() + static_cast<ptrdiff_t>(end));
+        std::rotate(peers.begin() + static_cast<ptrdiff_t>(i), peers.begin() + static_cast<ptrdiff_t>(i) + 1,
+                    peers.end());
+        return responseTime(peers, end - 1);
+    }
+
+    // Every task meets its deadline; stops at the first that does not
+    static bool feasible(const std::vector<TaskTiming>& tasks)
+    {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (responseTime(tasks, i) == Unschedulable) return false;
+        }
+        return true;
+    }
+
+    static bool feasible(const std::vector<TaskTiming>& tasks, const std::vector<int>& priorities)
+    {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (responseTime(tasks, i, priorities) == Unschedulable) return false;
+        }
+        return true;
+    }
+
+    // Largest factor every WCET can be scaled by with the set still
+    // feasible: above 1 the headroom, below 1 how far an infeasible set is
+    // off. Binary search to a relative precision, between 1 and the upper
+    // bound from U <= 1 and B + C + J <= D; each probe stops at the first
+    // miss. Infinite for an empty set.
+    static double criticalScalingFactor(const std::vector<TaskTiming>& tasks, double precision = 1e-4)
+    {
+        return criticalScalingFactor(tasks, {}, precision);
+    }
+
+    static double criticalScalingFactor(const std::vector<TaskTiming>& tasks, const std::vector<int>& priorities,
+                                        double precision = 1e-4)
+    {
+        if (tasks.empty()) return std::numeric_limits<double>::infinity();
+        double high = 1.0 / utilization(tasks);
+        for (const auto& task : tasks) {
+            double room = static_cast<double>(task.deadline() - task.jitterNs - task.blockingNs);
+            high = std::min(high, room / static_cast<double>(task.wcetNs));
+        }
+        if (high <= 0.0) return 0.0;
+
+        std::vector<TaskTiming> scaled = tasks;
+        auto fits = [&](double factor) {
+            for (size_t i = 0; i < tasks.size(); ++i) {
+                scaled[i].wcetNs = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(tasks[i].wcetNs * factor)));
+            }
+            return feasible(scaled, priorities);
+        };
+        if (fits(high)) return high;
+        double low = 0.0;
+        if (high > 1.0) {
+            if (fits(1.0)) low = 1.0;
+            else high = 1.0;
+        }
+        while (high - low > precision * high) {
+            double middle = (low + high) / 2.0;
+            if (fits(middle)) low = middle;
+            else high = middle;
+        }
+        return low;
+    }
+
+    // Largest WCET tasks[i] can have, the others unchanged, with every task
+    // still meeting its deadline; 0 if none would (a higher-priority task
+    // already misses). Binary search in ns; a probe only analyses tasks[i..]
+    // (and the peers sharing its priority) and stops at the first miss.
+    static int64_t maxWcet(const std::vector<TaskTiming>& tasks, size_t i)
+    {
+        return maxWcet(tasks, i, {});
+    }
+
+    static int64_t maxWcet(const std::vector<TaskTiming>& tasks, size_t i, const std::vector<int>& priorities)
+    {
+        size_t first = i;
+        while (!priorities.empty() && first > 0 && priorities[first - 1] == priorities[i]) --first;
+        for (size_t j = 0; j < first; ++j) {
+            if (responseTime(tasks, j, priorities) == Unschedulable) return 0;
+        }
+        const TaskTiming& task = tasks[i];
+        const double others = utilization(tasks) - task.utilization();
+        int64_t high = task.deadline() - task.jitterNs - task.blockingNs;
+        const double room = 1.0 - others + _utilizationTolerance(tasks.size());   // never below the exact room
+        if (room < 1.0) {
+            high = std::min(high, static_cast<int64_t>(std::ceil(room * static_cast<double>(task.periodNs))) + 1);
+        }
+        if (high < 1) return 0;
+
+        std::vector<TaskTiming> changed = tasks;
+        auto fits = [&](int64_t wcet) {
+            changed[i].wcetNs = wcet;
+            for (size_t j = first; j < changed.size(); ++j) {
+                if (responseTime(changed, j, priorities) == Unschedulable) return false;
+            }
+            return true;
+        };
+        if (fits(high)) return high;
+        int64_t low = 0;
+        if (task.wcetNs > 0 && task.wcetNs < high) {
+            if (fits(task.wcetNs)) low = task.wcetNs;
+            else high = task.wcetNs;
+        }
+        while (high - low > 1) {
+            int64_t middle = low + (high - low) / 2;
+            if (fits(middle)) low = middle;
+            else high = middle;
+        }
+        return low;
+    }
+
+    // Audsley's optimal priority assignment. Fills order with indices into
+    // tasks, highest priority first, such that every task meets its
+    // deadline; false, with order deadline monotonic (by D - J), if no
+    // fixed-priority order does. Works because a task's response time
+    // depends on which tasks are above it, not on their order: from the
+    // lowest level up, any unplaced task that meets its deadline below all
+    // the others can take that level. Candidates are tried in decreasing
+    // D - J, so for sets DM already schedules the first one fits and the
+    // assignment costs n analyses rather than up to n^2 / 2.
+    static bool assignPriorities(const std::vector<TaskTiming>& tasks, std::vector<size_t>& order)
+    {
+        const size_t n = tasks.size();
+        order.resize(n);
+        auto deadlineMonotonic = [&tasks, &order] {
+            std::iota(order.begin(), order.end(), size_t{0});
+            std::stable_sort(order.begin(), order.end(), [&tasks](size_t a, size_t b) {
+                return tasks[a].deadline() - tasks[a].jitterNs < tasks[b].deadline() - tasks[b].jitterNs;
+            });
+        };
+        deadlineMonotonic();
+
+        // pending[0..level] are unplaced, in that order; a candidate is
+        // rotated to level so the rest keep theirs
+        std::vector<TaskTiming> pending(n);
+        for (size_t k = 0; k < n; ++k) pending[k] = tasks[order[k]];
+        for (size_t level = n; level-- > 0;) {
+            bool placed = false;
+            for (size_t candidate = level + 1; candidate-- > 0 && !placed;) {
+                auto rotate = [candidate, level](auto& items, bool back) {
+                    auto first = items.begin() + static_cast<ptrdiff_t>(candidate);
+                    auto last = items.begin() + static_cast<ptrdiff_t>(level) + 1;
+                    std::rotate(first, back ? last - 1 : first + 1, last);
+                };
+                rotate(pending, false);
+                rotate(order, false);
+                placed = responseTime(pending, level) != Unschedulable;
+                if (!placed) {
+                    rotate(pending, true);
+                    rotate(order, true);
+                }
+            }
+            if (!placed) {
+                deadlineMonotonic();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Response time of every task; feasible if all meet their deadlines
+    static Analysis analyze(const std::vector<TaskTiming>& tasks)
+    {
+        Analysis analysis{true, std::vector<int64_t>(tasks.size())};
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            analysis.responseNs[i] = responseTime(tasks, i);
+            if (analysis.responseNs[i] == Unschedulable) analysis.feasible = false;
+        }
+        return analysis;
+    }
+
+    static Analysis analyze(const std::vector<TaskTiming>& tasks, const std::vector<int>& priorities)
+    {
+        Analysis analysis{true, std::vector<int64_t>(tasks.size())};
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            analysis.responseNs[i] = responseTime(tasks, i, priorities);
+            if (analysis.responseNs[i] == Unschedulable) analysis.feasible = false;
+        }
+        return analysis;
+    }
+
+    // Reduced scheduling points of tasks[i] (Bini & Buttazzo), ascending:
+    //   P_0(t) = {t},  P_j(t) = P_{j-1}(floor(t / T_j) T_j)  u  P_{j-1}(t)
+    // over P_{i-1}(D_i). Only these instants can be the first at which the
+    // processor demand of tasks[0..i] is met, instead of every multiple of
+    // every higher-priority period up to D_i. Points below from are dropped
+    // as they are generated, with everything they would expand into.
+    static void schedulingPoints(const std::vector<TaskTiming>& tasks, size_t i, std::vector<double>& points,
+                                 int64_t from = 1)
+    {
+        points.assign(1, static_cast<double>(tasks[i].deadline()));
+        for (size_t j = i; j-- > 0;) {
+            const int64_t period = tasks[j].periodNs;
+            const size_t count = points.size();
+            for (size_t p = 0; p < count; ++p) {
+                const auto t = static_cast<int64_t>(points[p]);
+                const int64_t earlier = t / period * period;
+                if (earlier >= from && earlier != t) points.push_back(static_cast<double>(earlier));
+            }
+            // floor(t / T) T is monotonic in t, so the new points are
+            // already ascending: merge instead of sorting
+            if (points.size() > count) {
+                std::inplace_merge(points.begin(), points.begin() + static_cast<ptrdiff_t>(count), points.end());
+                points.erase(std::unique(points.begin(), points.end()), points.end());
+            }
+        }
+    }
+
+    // Lehoczky, Sha & Ding: tasks[i] meets its deadline iff at some
+    // scheduling point t
+    //   B + C_i + sum_{j<i} ceil(t / T_j) C_j <= t
+    // D itself is tried first, exactly. Otherwise, as the demand is at
+    // least B + C_i + sum_{j<i} C_j and at least B + C_i + t U_hp, only
+    // points from the larger of those bounds on are generated, and they are
+    // tried in ascending blocks until one is met.
+    // Tasks with D > T or jitter (own or higher-priority) go through
+    // responseTime() instead. Times are exact in double below 2^53 ns.
+    static bool schedulingPointFeasible(const std::vector<TaskTiming>& tasks)
+    {
+        constexpr size_t Block = 256;
+
+        // Structure of arrays, so that the demand loop over a block of
+        // points vectorizes (needs a vector ceil: SSE4.1 or NEON, and
+        // -fno-trapping-math)
+        std::vector<double> period(tasks.size()), wcet(tasks.size());
+        std::vector<double> points, demand(Block);
+        bool jitter = false;
+        double load = 0.0;
+        int64_t higherWcet = 0;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            const TaskTiming& task = tasks[i];
+            period[i] = static_cast<double>(task.periodNs);
+            wcet[i] = static_cast<double>(task.wcetNs);
+            jitter = jitter || task.jitterNs != 0;
+            const double higherLoad = load;
+            const int64_t higher = higherWcet;
+            load += task.utilization();
+            higherWcet += task.wcetNs;
+
+            if (jitter || task.deadline() > task.periodNs) {
+                if (responseTime(tasks, i) == Unschedulable) return false;
+                continue;
+            }
+
+            const int64_t own = task.blockingNs + task.wcetNs;
+            const int64_t deadline = task.deadline();
+            int64_t atDeadline = own;
+            for (size_t j = 0; j < i; ++j) atDeadline += _ceilDiv(deadline, tasks[j].periodNs) * tasks[j].wcetNs;
+            if (atDeadline <= deadline) continue;
+
+            // Rounded down a little, so rounding never drops a point
+            int64_t from = own + higher;
+            if (higherLoad < 1.0) {
+                from = std::max(from, static_cast<int64_t>(own / (1.0 - higherLoad) * (1.0 - 1e-9)));
+            }
+            schedulingPoints(tasks, i, points, from);
+
+            bool met = false;
+            for (size_t begin = 0; begin < points.size() && !met; begin += Block) {
+                const double* t = points.data() + begin;
+                const size_t count = std::min(Block, points.size() - begin);
+                std::fill_n(demand.begin(), count, static_cast<double>(own));
+                for (size_t j = 0; j < i; ++j) {
+                    const double p = period[j], c = wcet[j];
+                    for (size_t k = 0; k < count; ++k) demand[k] += std::ceil(t[k] / p) * c;
+                }
+                for (size_t k = 0; k < count && !met; ++k) met = demand[k] <= t[k];
+            }
+            if (!met) return false;
+        }
+        return true;
+    }
+
+private:
+    __extension__ typedef __int128 Int128;
+
+    static int64_t _ceilDiv(int64_t numerator, int64_t denominator)
+    {
+        return numerator <= 0 ? 0 : (numerator + denominator - 1) / denominator;
+    }
+
+    // Bound on the rounding error of a double sum of count utilizations
+    static double _utilizationTolerance(size_t count)
+    {
+        return static_cast<double>(count + 1) * 0x1p-50;
+    }
+
+    static Int128 _gcd(Int128 a, Int128 b)
+    {
+        while (b != 0) {
+            Int128 rest = a % b;
+            a = b;
+            b = rest;
+        }
+        return a;
+    }
+};
+
+// Response times of a growing service set, kept up to date incrementally.
+// A change at priority position i leaves the tasks above i untouched. For
+// each task below it:
+//  - first an O(1) linear upper bound on its response time (Bini, Nguyen,
+//    Richard & Baruah), from prefix sums over the higher-priority tasks:
+//      R <= (B + C + sum_j C_j (1 - U_j) + U_j J_j) / (1 - sum_j U_j) + J
+//    If that meets the deadline the task stays schedulable and its exact
+//    response time is only computed when asked for (responseTime()).
+//  - otherwise exact analysis; when the change only added interference
+//    (new task, larger WCET) it restarts from the task's previous first-job
+//    completion, still a lower bound, instead of from scratch.
+// Admission changes that would make the set infeasible stop at the first
+// miss and leave the set as it was.
+class IncrementalRta
+{
+public:
+    size_t size() const
+    {
+        return _tasks.size();
+    }
+
+    const TaskTiming& task(size_t i) const
+    {
+        return _tasks[i];
+    }
+
+    const std::vector<TaskTiming>& tasks() const
+    {
+        return _tasks;
+    }
+
+    // Exact response time (Schedulability::Unschedulable on a miss)
+    int64_t responseTime(size_t i)
+    {
+        if (_response[i] == Pending) {
+            _response[i] = Schedulability::responseTime(_tasks, i, _firstJob[i], &_firstJob[i]);
+        }
+        return _response[i];
+    }
+
+    bool feasible() const
+    {
+        return _misses == 0;
+    }
+
+    // Adds task at priority position (0 = highest), even if infeasible
+    void insert(size_t position, const TaskTiming& task)
+    {
+        _insert(position, task);
+        _analyze(position, false, true);
+        _commit(position);
+    }
+
+    // Admission decision: adds the task only if every task still meets its
+    // deadline
+    bool tryInsert(size_t position, const TaskTiming& task)
+    {
+        if (!feasible()) return false;
+        _insert(position, task);
+        if (!_analyze(position, true, true)) {
+            _erase(position);
+            _updatePrefix(position);
+            return false;
+        }
+        _commit(position);
+        return true;
+    }
+
+    // Changes a WCET only if the set stays feasible
+    bool trySetWcet(size_t i, int64_t wcetNs)
+    {
+        if (!feasible()) return false;
+        int64_t previous = _tasks[i].wcetNs;
+        bool grows = wcetNs >= previous;
+        _tasks[i].wcetNs = wcetNs;
+        if (!_analyze(i, true, grows)) {
+            _tasks[i].wcetNs = previous;
+            _updatePrefix(i);
+            return false;
+        }
+        _commit(i);
+        return true;
+    }
+
+    void erase(size_t i)
+    {
+        _erase(i);
+        _analyze(i, false, false);
+        _commit(i);
+    }
+
+private:
+    static constexpr int64_t Pending = -1;   // bounded, exact value not computed yet
+
+    std::vector<TaskTiming> _tasks;
+    std::vector<int64_t> _response;   // exact, Unschedulable or Pending
+    std::vector<int64_t> _firstJob;   // lower bound on the first job's completion
+    size_t _misses = 0;
+
+    // Over tasks [0, k): sum U_j, and sum C_j (1 - U_j) + U_j J_j
+    std::vector<double> _prefixUtilization{0.0};
+    std::vector<double> _prefixOffset{0.0};
+
+    // Results of the pending change for tasks [from, n), committed or dropped
+    std::vector<int64_t> _newResponse;
+    std::vector<int64_t> _newFirstJob;
+
+    void _insert(size_t position, const TaskTiming& task)
+    {
+        _tasks.insert(_tasks.begin() + static_cast<ptrdiff_t>(position), task);
+        _response.insert(_response.begin() + static_cast<ptrdiff_t>(position), Pending);
+        _firstJob.insert(_firstJob.begin() + static_cast<ptrdiff_t>(position), 0);
+    }
+
+    void _erase(size_t position)
+    {
+        _tasks.erase(_tasks.begin() + static_cast<ptrdiff_t>(position));
+        _response.erase(_response.begin() + static_cast<ptrdiff_t>(position));
+        _firstJob.erase(_firstJob.begin() + static_cast<ptrdiff_t>(position));
+    }
+
+    void _updatePrefix(size_t from)
+    {
+        size_t n = _tasks.size();
+        _prefixUtilization.resize(n + 1);
+        _prefixOffset.resize(n + 1);
+        for (size_t k = from; k < n; ++k) {
+            const TaskTiming& task = _tasks[k];
+            double u = task.utilization();
+            _prefixUtilization[k + 1] = _prefixUtilization[k] + u;
+            _prefixOffset[k + 1] = _prefixOffset[k] + task.wcetNs * (1.0 - u) + u * task.jitterNs;
+        }
+    }
+
+    // Linear upper bound meets the deadline (constrained deadlines only)
+    bool _boundedBelowDeadline(size_t i) const
+    {
+        const TaskTiming& task = _tasks[i];
+        if (task.deadline() > task.periodNs) return false;
+        double free = 1.0 - _prefixUtilization[i];
+        if (free <= 1e-9) return false;
+        double bound = (task.blockingNs + task.wcetNs + _prefixOffset[i]) / free + task.jitterNs;
+        // Margin for the rounding of the prefix sums
+        return bound * (1.0 + 1e-9) + 1.0 <= static_cast<double>(task.deadline());
+    }
+
+    // Analyses tasks [from, n); warm = interference only grew, so cached
+    // completions are lower bounds. Returns false at the first miss if
+    // stopAtMiss.
+    bool _analyze(size_t from, bool stopAtMiss, bool warm)
+    {
+        _updatePrefix(from);
+        size_t n = _tasks.size();
+        _newResponse.resize(n);
+        _newFirstJob.resize(n);
+        for (size_t i = from; i < n; ++i) {
+            int64_t start = warm ? _firstJob[i] : 0;
+            if (_boundedBelowDeadline(i)) {
+                _newResponse[i] = Pending;
+                _newFirstJob[i] = start;
+                continue;
+            }
+            _newResponse[i] = Schedulability::responseTime(_tasks, i, start, &_newFirstJob[i]);
+            if (stopAtMiss && _newResponse[i] == Schedulability::Unschedulable) return false;
+        }
+        return true;
+    }
+
+    void _commit(size_t from)
+    {
+        size_t n = _tasks.size();
+        std::copy(_newResponse.begin() + static_cast<ptrdiff_t>(from), _newResponse.begin() + static_cast<ptrdiff_t>(n),
+                  _response.begin() + static_cast<ptrdiff_t>(from));
+        std::copy(_newFirstJob.begin() + static_cast<ptrdiff_t>(from), _newFirstJob.begin() + static_cast<ptrdiff_t>(n),
+                  _firstJob.begin() + static_cast<ptrdiff_t>(from));
+        _misses = static_cast<size_t>(std::count(_response.begin(), _response.end(), Schedulability::Unschedulable));
+    }
+};
@@ -8,13 +8,17 @@
  */
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <csignal>
 #include <atomic>
 #include <chrono>
 #include <thread>
+#include <vector>
 #include <sys/syslog.h>
 #include <sched.h>
+#include <unistd.h>
 #include "Sequencer.hpp"
+#include "Workload.hpp"
 
 // Global termination flag for signal handling
 std::atomic<bool> terminateProgram{false};
@@ -25,7 +29,7 @@ void signalHandler(int signum) {
     }
 }
 
-// Fibonacci Load Generator for simulating CPU work
+// Fibonacci kernel for the short control job
 uint64_t fibonacciIterative(uint64_t n) {
     if (n <= 1) return n;
     
@@ -38,39 +42,70 @@ uint64_t fibonacciIterative(uint64_t n) {
     return b;
 }
 
-void generateLoad(double targetMilliseconds) {
-    auto start = std::chrono::high_resolution_clock::now();
-    uint64_t iterations = 0;
-    
-    while (true) {
-        fibonacciIterative(100);  // Do some work
-        iterations++;
-        
-        auto now = std::chrono::high_resolution_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start).count();
-        
-        if (elapsed >= targetMilliseconds * 1000) {
-            break;
-        }
-    }
-}
+// Calibrated job bodies: a fixed amount of work per job, no clock reads
+Workload workload;
+Workload::Kernel loadKernel = Workload::Kernel::IntegerAlu;
 
 // Service functions
 void service1() {
-    // Generate load for approximately 30.04ms
-    generateLoad(10);
+    // 10ms of work on an idle core
+    workload.run(loadKernel, std::chrono::milliseconds(10));
 }
 
 void service2() {
-    // Generate load for approximately 61.00ms
-    generateLoad(20);
+    // 20ms of work on an idle core
+    workload.run(loadKernel, std::chrono::milliseconds(20));
+}
+
+// Short control-loop job for the high-rate sleep-then-spin service
+volatile uint64_t controlOutput = 0;
+
+void controlService() {
+    controlOutput = fibonacciIterative(20);
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-m dispatcher|timer] [-c control_hz] [-H histogram_file] [-t trace_file] [-k] [-w alu|fp|stream|chase] [-F] [runtime_seconds]\n", prog);
 }
 
 int main(int argc, char* argv[]) {
     int runtime_seconds = 10; // Default runtime
+    Sequencer::ReleaseMode releaseMode = Sequencer::ReleaseMode::Dispatcher;
+    int controlHz = 0;  // 0 = no control service
+    const char* histogramFile = nullptr;  // latency histograms merged across runs
+    const char* traceFile = nullptr;      // per-job trace, see trace_decode
+    bool forceStart = false;              // start even if not schedulable
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:c:H:t:kw:F")) != -1) {
+        if (opt == 'c' && std::atoi(optarg) > 0) {
+            controlHz = std::atoi(optarg);
+        } else if (opt == 'H') {
+            histogramFile = optarg;
+        } else if (opt == 't') {
+            traceFile = optarg;
+        } else if (opt == 'k') {
+            // Job markers in the kernel trace, see TraceMarker.hpp / trace_merge
+            if (!TraceMarker::open()) {
+                std::fprintf(stderr, "Cannot open trace_marker (tracefs mounted? root?)\n");
+                return 1;
+            }
+        } else if (opt == 'F') {
+            forceStart = true;
+        } else if (opt == 'w' && Workload::parse(optarg, loadKernel)) {
+            // Load kernel of service1/service2, see Workload.hpp
+        } else if (opt == 'm' && std::strcmp(optarg, "dispatcher") == 0) {
+            releaseMode = Sequencer::ReleaseMode::Dispatcher;
+        } else if (opt == 'm' && std::strcmp(optarg, "timer") == 0) {
+            releaseMode = Sequencer::ReleaseMode::TimerThread;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
     
-    if (argc > 1) {
-        runtime_seconds = std::atoi(argv[1]);
+    if (optind < argc) {
+        runtime_seconds = std::atoi(argv[optind]);
         if (runtime_seconds <= 0) {
             std::fprintf(stderr, "Invalid runtime. Using default 10 seconds.\n");
             runtime_seconds = 10;
@@ -96,24 +131,80 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    // Create sequencer
-    Sequencer sequencer{};
-
-    // Add services with Rate Monotonic priority assignment
-    // Service 1: Period = 20ms, Priority = maxPriority - 1 (higher)
-    sequencer.addService(service1, 0, maxPriority - 1, 20);
-
-    // Service 2: Period = 50ms, Priority = maxPriority - 2 (lower)
-    sequencer.addService(service2, 0, maxPriority - 2, 50);
+    // Calibrate the job bodies on the services' core before any service
+    // runs, then restore main's affinity so the threads it creates later
+    // (dispatcher, timer helpers, trace drain) do not inherit core 0
+    cpu_set_t mainCpus;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mainCpus);
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(0, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    RtClock::init();
+    workload.calibrate();
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mainCpus);
+    workload.printCalibration();
+    std::printf("\n");
+
+    // Create sequencer; an unschedulable service set is refused unless -F
+    Sequencer sequencer{releaseMode};
+    sequencer.setAdmission(forceStart ? Sequencer::Admission::Warn : Sequencer::Admission::Refuse);
+
+    // Service timing models; priorities below maxPriority by Audsley's
+    // optimal priority assignment, which finds a feasible order whenever
+    // one exists (also where rate/deadline monotonic does not)
+    struct ServiceSpec {
+        void (*job)();
+        const char* name;
+        std::chrono::milliseconds period;
+        std::chrono::milliseconds wcet;
+    };
+    const std::vector<ServiceSpec> specs = {
+        {service1, "Service 1", std::chrono::milliseconds(20), std::chrono::milliseconds(10)},
+        {service2, "Service 2", std::chrono::milliseconds(50), std::chrono::milliseconds(20)},
+    };
+    std::vector<TaskTiming> timings;
+    for (const auto& spec : specs) {
+        timings.push_back(TaskTiming{std::chrono::nanoseconds(spec.wcet).count(),
+                                     std::chrono::nanoseconds(spec.period).count()});
+    }
+    std::vector<size_t> order;
+    if (Schedulability::assignPriorities(timings, order)) {
+        std::printf("Starting services with optimal (Audsley) priority assignment\n");
+    } else {
+        // No order works; the admission check reports the misses
+        std::printf("No feasible priority order; starting services in deadline monotonic order\n");
+    }
+    for (size_t rank = 0; rank < order.size(); ++rank) {
+        const auto& spec = specs[order[rank]];
+        int priority = maxPriority - 1 - static_cast<int>(rank);
+        sequencer.addService(spec.job, 0, priority, spec.period).setTiming(spec.wcet);
+        std::printf("%s: period=%ldms, priority=%d, target WCET=%ldms (%s)\n", spec.name,
+                    static_cast<long>(spec.period.count()), priority, static_cast<long>(spec.wcet.count()),
+                    Workload::name(loadKernel));
+    }
 
-    std::printf("Starting services with Rate Monotonic scheduling\n");
-    std::printf("Service 1: period=20ms, priority=%d, target WCET=30ms\n", maxPriority - 1);
-    std::printf("Service 2: period=50ms, priority=%d, target WCET=61ms\n", maxPriority - 2);
+    // Optional high-rate control service released by sleep-then-spin
+    if (controlHz > 0) {
+        sequencer.addService(controlService, 0, maxPriority, std::chrono::nanoseconds(1000000000 / controlHz))
+                 .enableSleepSpin();
+        std::printf("Control: rate=%dHz, priority=%d, sleep-then-spin release\n", controlHz, maxPriority);
+    }
+    if (traceFile != nullptr) {
+        sequencer.enableTrace(traceFile);
+        std::printf("Trace: %s\n", traceFile);
+    }
+    std::printf("Release mode: %s\n", sequencer.releaseModeName());
     std::printf("Runtime: %d seconds (or press Ctrl+C to terminate)\n", runtime_seconds);
     std::printf("----------------------------------------\n\n");
 
     // Start services
-    sequencer.startServices();
+    sequencer.checkSchedulability();
+    if (!sequencer.startServices()) {
+        std::fprintf(stderr, "Service set is not schedulable; use -F to start it anyway\n");
+        sequencer.stopServices(false);
+        return 1;
+    }
 
     // Wait for termination signal or runtime expiration
     auto start_time = std::chrono::steady_clock::now();
@@ -136,6 +227,14 @@ int main(int argc, char* argv[]) {
     // Stop services  
     sequencer.stopServices();
 
+    if (histogramFile != nullptr) {
+        if (sequencer.saveHistograms(histogramFile)) {
+            std::printf("Latency histograms merged into %s\n", histogramFile);
+        } else {
+            std::fprintf(stderr, "Failed to save latency histograms to %s\n", histogramFile);
+        }
+    }
+
     std::printf("\nReal-time services demonstration completed.\n");
     syslog(LOG_INFO, "Real-time services demonstration completed");
     closelog();
@@ -10,10 +10,8 @@
  #pragma once
 
  #include <cstdint>
- #include <functional>
  #include <thread>
  #include <vector>
- #include <semaphore>
  #include <atomic>
  #include <sys/syslog.h>
  #include <sched.h>
@@ -27,6 +25,20 @@
  #include <chrono>
  #include <mutex>
  #include <memory>
+ #include <map>
+ #include <string>
+ #include <array>
+ #include <cerrno>
+ #include <type_traits>
+ #include <time.h>
+ #include "FutexRelease.hpp"
+ #include "LatencyHistogram.hpp"
+ #include "ReleaseStages.hpp"
+ #include "RtClock.hpp"
+ #include "Schedulability.hpp"
+ #include "SeqLock.hpp"
+ #include "TraceMarker.hpp"
+ #include "TraceRecorder.hpp"
  
  // The service class contains the service function and service parameters
  // (priority, affinity, etc). It spawns a thread to run the service, configures
@@ -39,27 +51,42 @@
          double maxExecutionTime{0.0};
          double totalExecutionTime{0.0};
          uint64_t executionCount{0};
-         double minStartJitter{std::numeric_limits<double>::max()};
-         double maxStartJitter{0.0};
-         double totalStartJitter{0.0};
          uint64_t deadlineMisses{0};
+         uint64_t missedReleases{0};   // releases that arrived while the previous job still ran
          double maxLateness{0.0};
-         std::chrono::steady_clock::time_point firstRelease;
-         std::chrono::steady_clock::time_point lastExpectedRelease;
-         bool firstReleaseSet{false};
+ 
+         // Sleep-then-spin release (see enableSleepSpin)
+         int64_t guardBandNs{0};
+         int64_t wakeupLatencyP99Ns{0};
+         uint64_t lateWakeups{0};
+         int64_t totalSpinNs{0};
+         std::chrono::steady_clock::time_point firstSelfRelease;
+         std::chrono::steady_clock::time_point lastSelfRelease;
      };
  
+     // period in milliseconds
      template<typename T>
      Service(T&& doService, uint8_t affinity, uint8_t priority, uint32_t period) :
-         _doService(doService),
+         Service(std::forward<T>(doService), affinity, priority, std::chrono::milliseconds(period))
+     {
+     }
+ 
+     // Sub-millisecond periods, e.g. std::chrono::microseconds(100) for 10 kHz
+     template<typename T>
+     Service(T&& doService, uint8_t affinity, uint8_t priority, std::chrono::nanoseconds period) :
          _affinity(affinity),
          _priority(priority),
          _period(period),
-         _semaphore(0),
+         _deadline(period),
          _running(true)
      {
-         // Start the service thread, which will begin running the given function immediately
-         _service = std::jthread(&Service::_provideService, this);
+         // All statistics are timestamped with RtClock; calibrate it once
+         RtClock::init();
+ 
+         // Start the service thread, which will begin running the given function immediately.
+         // The function moves into the thread, and the service loop is instantiated for its
+         // type: a lambda is called directly (inlined), a function pointer with one call.
+         _service = std::jthread(&Service::_provideService<std::decay_t<T>>, this, std::forward<T>(doService));
      }
  
      // Delete copy operations
@@ -72,18 +99,78 @@
   
      void stop(){
          _running = false;
-         // Release the semaphore one more time in case the service is waiting
-         _semaphore.release();
+         // Release one more time in case the service is waiting
+         std::lock_guard<std::mutex> lock(_postLock);
+         _release.post({});
+     }
+ 
+     // Wait for the service thread to finish its last job and exit
+     void join(){
+         if (_service.joinable()) {
+             _service.join();
+         }
      }
   
-     void release(){
-         _semaphore.release();
+     // Release from a source that does not know the scheduled instant (the
+     // SIGEV_THREAD timer): charge the job to the latest scheduled release.
+     // Helper threads of consecutive expiries can overlap, so their posts
+     // are serialized. Returns the scheduled release.
+     std::chrono::steady_clock::time_point release(){
+         auto handler = RtClock::now();
+         auto scheduled = scheduledReleaseBefore(handler);
+         std::lock_guard<std::mutex> lock(_postLock);
+         release(scheduled, handler);
+         return scheduled;
+     }
+ 
+     // Single releaser. handler = when the releasing thread started running
+     // for this release; when given, the job's release path is broken down
+     // into stages. skipped = later releases the releaser fell too far
+     // behind to make; they are counted as missed releases of this job.
+     void release(std::chrono::steady_clock::time_point scheduled,
+                  std::chrono::steady_clock::time_point handler = {}, uint32_t skipped = 0){
+         _skippedPosted += skipped;
+         ReleaseRecord record{scheduled, handler, {}, _skippedPosted};
+         if (handler != std::chrono::steady_clock::time_point{}) {
+             record.post = RtClock::now();
+         }
+         _release.post(record);
      }
  
-     uint32_t getPeriod() const {
+     // Releases are scheduled at epoch + k * period for k >= 1
+     void setReleaseEpoch(std::chrono::steady_clock::time_point epoch) {
+         _releaseEpoch = epoch;
+     }
+ 
+     std::chrono::steady_clock::time_point scheduledReleaseBefore(std::chrono::steady_clock::time_point now) const {
+         if (now <= _releaseEpoch) return _releaseEpoch;
+         return _releaseEpoch + ((now - _releaseEpoch) / _period) * _period;
+     }
+ 
+     std::chrono::nanoseconds getPeriod() const {
          return _period;
      }
  
+     // Hybrid release for short periods: instead of waiting to be released,
+     // the service thread sleeps with an absolute timer until a guard band
+     // before each release and then spins on the clock until the release
+     // instant. The guard band starts at initialGuard and is re-tuned every
+     // SpinTuneWindow jobs from the p99 of the observed wakeup latency.
+     // Must be called before the Sequencer starts the services.
+     void enableSleepSpin(std::chrono::nanoseconds initialGuard = std::chrono::microseconds(100)) {
+         _guardBandNs.store(initialGuard.count(), std::memory_order_relaxed);
+         _sleepSpin = true;
+     }
+ 
+     bool isSelfTimed() const {
+         return _sleepSpin;
+     }
+ 
+     // Self-timed services are started once; the first release is at epoch + period
+     void startSelfTimed() {
+         _release.post({});
+     }
+ 
      void setTimerId(timer_t timerId) {
          _timerId = timerId;
      }
@@ -92,64 +179,178 @@
          return _timerId;
      }
  
+     // Consistent snapshot of the statistics; safe from any thread while the
+     // service runs and never blocks the service thread
+     Statistics statistics() const {
+         return _publishedStats.load();
+     }
+ 
+     // Per-job latency distributions in ns, readable while the service runs:
+     // release jitter (start - scheduled release), execution time, and
+     // response time (completion - scheduled release)
+     const LatencyHistogram& releaseJitterHistogram() const { return _releaseJitterNs; }
+     const LatencyHistogram& executionTimeHistogram() const { return _executionTimeNs; }
+     const LatencyHistogram& responseTimeHistogram() const { return _responseTimeNs; }
+     const ReleaseStages& releaseStages() const { return _releaseStages; }
+ 
+     uint8_t getPriority() const {
+         return _priority;
+     }
+ 
+     uint8_t getAffinity() const {
+         return _affinity;
+     }
+ 
+     // Timing model for the Sequencer's admission check (Schedulability.hpp):
+     // WCET, relative deadline (zero = period), release jitter and blocking.
+     // The deadline also drives the deadline-miss statistics.
+     Service& setTiming(std::chrono::nanoseconds wcet, std::chrono::nanoseconds deadline = {},
+                        std::chrono::nanoseconds jitter = {}, std::chrono::nanoseconds blocking = {}) {
+         _wcet = wcet;
+         _deadline = deadline.count() > 0 ? deadline : _period;
+         _jitter = jitter;
+         _blocking = blocking;
+         return *this;
+     }
+ 
+     // Services without a WCET are left out of the admission check
+     bool hasTiming() const {
+         return _wcet.count() > 0;
+     }
+ 
+     TaskTiming timing() const {
+         return TaskTiming{_wcet.count(), _period.count(), _deadline.count(), _jitter.count(), _blocking.count()};
+     }
+ 
+     // Index in the Sequencer, used as the service id in trace markers
+     void setId(uint16_t id) {
+         _id = id;
+     }
+ 
+     uint16_t getId() const {
+         return _id;
+     }
+ 
+     // Record every job into ring (owned by a TraceRecorder); set before start
+     void setTraceRing(TraceRing* ring) {
+         _traceRing = ring;
+     }
+ 
      void printStatistics() const {
-         std::lock_guard<std::mutex> lock(_statsMutex);
+         Statistics stats = statistics();
          
-         if (_stats.executionCount == 0) {
-             printf("Service (period=%ums): No executions\n", _period);
+         if (stats.executionCount == 0) {
+             printf("Service (period=%.3fms): No executions\n", _periodMs());
              return;
          }
  
-         double avgExecutionTime = _stats.totalExecutionTime / _stats.executionCount;
-         double avgStartJitter = _stats.totalStartJitter / _stats.executionCount;
+         double avgExecutionTime = stats.totalExecutionTime / stats.executionCount;
          
          // Calculate execution time jitter
-         double executionTimeJitter = _stats.maxExecutionTime - _stats.minExecutionTime;
-         
-         // Calculate start time jitter
-         double startTimeJitter = _stats.maxStartJitter - _stats.minStartJitter;
+         double executionTimeJitter = stats.maxExecutionTime - stats.minExecutionTime;
          
          // Calculate deadline miss rate
-         double deadlineMissRate = (_stats.deadlineMisses * 100.0) / _stats.executionCount;
+         double deadlineMissRate = (stats.deadlineMisses * 100.0) / stats.executionCount;
  
-         printf("\n=== Service Statistics (Period: %u ms, Priority: %u) ===\n", _period, _priority);
-         printf("Execution Count: %lu\n", _stats.executionCount);
+         printf("\n=== Service Statistics (Period: %.3f ms, Priority: %u) ===\n", _periodMs(), _priority);
+         printf("Execution Count: %lu\n", stats.executionCount);
          
          printf("Execution Time (ms):\n");
-         printf("  Min: %.3f\n", _stats.minExecutionTime);
-         printf("  Max: %.3f\n", _stats.maxExecutionTime);
+         printf("  Min: %.3f\n", stats.minExecutionTime);
+         printf("  Max: %.3f\n", stats.maxExecutionTime);
          printf("  Avg: %.3f\n", avgExecutionTime);
          printf("  Jitter: %.3f\n", executionTimeJitter);
          
+         // Start time jitter, from the release jitter histogram
          printf("Start Time Jitter (ms):\n");
-         printf("  Min: %.3f\n", _stats.minStartJitter);
-         printf("  Max: %.3f\n", _stats.maxStartJitter);
-         printf("  Avg: %.3f\n", avgStartJitter);
-         printf("  Range: %.3f\n", startTimeJitter);
+         printf("  Min: %.3f\n", _releaseJitterNs.min() / 1e6);
+         printf("  Max: %.3f\n", _releaseJitterNs.max() / 1e6);
+         printf("  Avg: %.3f\n", _releaseJitterNs.mean() / 1e6);
+         printf("  Range: %.3f\n", (_releaseJitterNs.max() - _releaseJitterNs.min()) / 1e6);
+         
+         printf("Latency Percentiles:\n");
+         LatencyHistogram::printPercentileHeader();
+         _releaseJitterNs.printPercentileRow("Release Jitter");
+         _executionTimeNs.printPercentileRow("Execution Time");
+         _responseTimeNs.printPercentileRow("Response Time");
+         if (_releaseStages.expiryToHandler.count() > 0) {
+             printf("Release Path:\n");
+             _releaseStages.printRows();
+         }
          
          printf("Deadline Analysis:\n");
-         printf("  Deadline: %u ms\n", _period);
-         printf("  Deadline Misses: %lu (%.2f%%)\n", _stats.deadlineMisses, deadlineMissRate);
-         if (_stats.deadlineMisses > 0) {
-             printf("  Max Lateness: %.3f ms\n", _stats.maxLateness);
+         printf("  Deadline: %.3f ms\n", _deadlineMs());
+         printf("  Deadline Misses: %lu (%.2f%%)\n", stats.deadlineMisses, deadlineMissRate);
+         if (stats.deadlineMisses > 0) {
+             printf("  Max Lateness: %.3f ms\n", stats.maxLateness);
+         }
+         printf("  Missed Releases: %lu\n", stats.missedReleases);
+         
+         if (_sleepSpin) {
+             double elapsedNs = std::chrono::duration<double, std::nano>(
+                 stats.lastSelfRelease - stats.firstSelfRelease).count();
+             printf("Sleep-then-spin Release:\n");
+             printf("  Guard Band: %.1f us (p99 wakeup latency %.1f us)\n",
+                    stats.guardBandNs / 1000.0, stats.wakeupLatencyP99Ns / 1000.0);
+             printf("  Late Wakeups (after release): %lu\n", stats.lateWakeups);
+             printf("  Spin: %.3f ms total, %.2f us/job, %.2f%% of one CPU\n",
+                    stats.totalSpinNs / 1e6,
+                    stats.totalSpinNs / 1000.0 / stats.executionCount,
+                    elapsedNs > 0 ? 100.0 * stats.totalSpinNs / elapsedNs : 0.0);
          }
          
          printf("================================================\n");
      }
   
  private:
-     std::function<void(void)> _doService;
      std::jthread _service;
      uint8_t _affinity;
      uint8_t _priority;
-     uint32_t _period;  // in milliseconds
-     std::counting_semaphore<1> _semaphore;
+     std::chrono::nanoseconds _period;
+     std::chrono::nanoseconds _deadline;
+     std::chrono::nanoseconds _wcet{0};
+     std::chrono::nanoseconds _jitter{0};
+     std::chrono::nanoseconds _blocking{0};
      std::atomic<bool> _running;
-     timer_t _timerId;
+     uint16_t _id{0};
+     timer_t _timerId{};
+     std::chrono::steady_clock::time_point _releaseEpoch{};
+
+     // Stamps of one release, handed to the service thread with it
+     struct ReleaseRecord {
+         std::chrono::steady_clock::time_point scheduled;   // planned release instant
+         std::chrono::steady_clock::time_point handler;     // releasing thread ran ({} = not stamped)
+         std::chrono::steady_clock::time_point post;        // release posted
+         uint64_t skipped;   // running total of releases the releaser dropped
+     };
+     FutexMailbox<ReleaseRecord> _release;
+     std::mutex _postLock;          // serializes posts from overlapping timer threads
+     uint64_t _skippedPosted{0};    // releaser side of ReleaseRecord::skipped
+     uint64_t _skippedSeen{0};      // service thread side
+ 
+     // Sleep-then-spin state, only touched by the service thread once started
+     static constexpr size_t SpinTuneWindow = 256;
+     std::atomic<bool> _sleepSpin{false};
+     std::atomic<int64_t> _guardBandNs{0};
+     bool _selfTimedStarted{false};
+     std::chrono::steady_clock::time_point _nextSelfRelease{};
+     std::chrono::nanoseconds _clockReadCost{0};
+     std::array<int64_t, SpinTuneWindow> _wakeupSamples{};
+     size_t _wakeupSampleCount{0};
      
      // Statistics
-     mutable std::mutex _statsMutex;
+     // _stats is only touched by the service thread, which publishes a copy
+     // through the seqlock after every job
      Statistics _stats;
+     SeqLock<Statistics> _publishedStats;
+ 
+     // Too large to copy through the seqlock every job; recorded in place
+     LatencyHistogram _releaseJitterNs;
+     LatencyHistogram _executionTimeNs;
+     LatencyHistogram _responseTimeNs;
+     ReleaseStages _releaseStages;
+ 
+     TraceRing* _traceRing{nullptr};
  
      void _initializeService()
      {
@@ -174,49 +375,158 @@
          }
      }
  
-     void _provideService()
+     double _periodMs() const {
+         return std::chrono::duration<double, std::milli>(_period).count();
+     }
+ 
+     double _deadlineMs() const {
+         return std::chrono::duration<double, std::milli>(_deadline).count();
+     }
+ 
+     static void _cpuRelax() {
+ #if defined(__x86_64__) || defined(__i386__)
+         __builtin_ia32_pause();
+ #elif defined(__aarch64__)
+         asm volatile("yield");
+ #endif
+     }
+ 
+     // Median cost of one clock read, so the spin can stop half a read early
+     void _calibrateSpinClock() {
+         std::array<int64_t, 101> samples;
+         for (auto& sample : samples) {
+             auto t0 = RtClock::now();
+             auto t1 = RtClock::now();
+             sample = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+         }
+         std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+         _clockReadCost = std::chrono::nanoseconds(samples[samples.size() / 2]);
+     }
+ 
+     // Guard band = p99 wakeup latency + 25% + one clock read, kept between
+     // 2 us and half a period (2 us when the period is under 4 us)
+     void _retuneGuardBand() {
+         auto scratch = _wakeupSamples;
+         size_t p99 = (scratch.size() * 99) / 100;
+         std::nth_element(scratch.begin(), scratch.begin() + p99, scratch.end());
+         int64_t latency = std::max<int64_t>(scratch[p99], 0);
+         int64_t guard = latency + latency / 4 + _clockReadCost.count();
+         guard = std::clamp<int64_t>(guard, 2000, std::max<int64_t>(2000, _period.count() / 2));
+         _guardBandNs.store(guard, std::memory_order_relaxed);
+         _stats.wakeupLatencyP99Ns = latency;
+     }
+ 
+     // Returns the number of releases skipped after an overrun
+     uint32_t _sleepSpinUntilRelease(ReleaseRecord& record) {
+         auto now = RtClock::now();
+ 
+         // Skip releases we can no longer make after an overrun
+         uint32_t skipped = 0;
+         while (_nextSelfRelease <= now) {
+             _nextSelfRelease += _period;
+             skipped++;
+         }
+         auto scheduled = _nextSelfRelease;
+         _nextSelfRelease += _period;
+         record = ReleaseRecord{scheduled, {}, {}, 0};
+ 
+         // Sleep phase: absolute wakeup one guard band before the release
+         auto guard = std::chrono::nanoseconds(_guardBandNs.load(std::memory_order_relaxed));
+         auto target = scheduled - guard;
+         auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(target.time_since_epoch()).count();
+         timespec wakeup{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+         while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR) {}
+ 
+         auto woke = RtClock::now();
+         _wakeupSamples[_wakeupSampleCount++ % SpinTuneWindow] =
+             std::chrono::duration_cast<std::chrono::nanoseconds>(woke - target).count();
+ 
+         // Spin phase: busy-wait until the release instant
+         auto spinUntil = scheduled - _clockReadCost / 2;
+         auto spinEnd = woke;
+         while (spinEnd < spinUntil) {
+             _cpuRelax();
+             spinEnd = RtClock::now();
+         }
+ 
+         if (woke >= scheduled) {
+             _stats.lateWakeups++;
+         }
+         _stats.totalSpinNs += std::chrono::duration_cast<std::chrono::nanoseconds>(spinEnd - woke).count();
+         _stats.guardBandNs = guard.count();
+         _stats.lastSelfRelease = scheduled;
+ 
+         if (_wakeupSampleCount % SpinTuneWindow == 0) {
+             _retuneGuardBand();
+         }
+         return skipped;
+     }
+ 
+     // Fills record with the release taken; returns the number of releases
+     // missed since the previous job
+     uint32_t _awaitRelease(ReleaseRecord& record) {
+         if (!_selfTimedStarted) {
+             auto delivery = _release.wait();
+             record = delivery.record;
+             // stop() and startSelfTimed() post empty records
+             uint32_t skipped = 0;
+             if (record.skipped > _skippedSeen) {
+                 skipped = static_cast<uint32_t>(record.skipped - _skippedSeen);
+                 _skippedSeen = record.skipped;
+             }
+             if (!_sleepSpin || !_running) return delivery.releases - 1 + skipped;   // ordinary release (or stop)
+ 
+             // startSelfTimed(): from here on this thread times its own releases
+             _selfTimedStarted = true;
+             _calibrateSpinClock();
+             _nextSelfRelease = _releaseEpoch + _period;
+             _stats.firstSelfRelease = _nextSelfRelease;
+         }
+         return _sleepSpinUntilRelease(record);
+     }
+ 
+     template<typename F>
+     void _provideService(F doService)
      {
          _initializeService();
          
          while (_running) {
 
-             _semaphore.acquire();
+             ReleaseRecord record;
+             uint32_t missed = _awaitRelease(record);
 
              if (!_running) break;                 // in case stop() was called
              else {
-                 auto releaseTime = std::chrono::steady_clock::now();
+                 auto releaseTime = RtClock::now();
+                 auto scheduledRelease = record.scheduled;
                  
-                 // Record release statistics
+                 // Record release statistics against the scheduled release instant
                  {
-                     std::lock_guard<std::mutex> lock(_statsMutex);
-                     
-                     if (!_stats.firstReleaseSet) {
-                         _stats.firstRelease = releaseTime;
-                         _stats.lastExpectedRelease = releaseTime;
-                         _stats.firstReleaseSet = true;
-                     } else {
-                         // Calculate start time jitter
-                         auto expectedRelease = _stats.lastExpectedRelease + std::chrono::milliseconds(_period);
-                         auto jitter = std::chrono::duration_cast<std::chrono::microseconds>(
-                             releaseTime - expectedRelease).count() / 1000.0; // Convert to ms
-                         
-                         _stats.minStartJitter = std::min(_stats.minStartJitter, std::abs(jitter));
-                         _stats.maxStartJitter = std::max(_stats.maxStartJitter, std::abs(jitter));
-                         _stats.totalStartJitter += std::abs(jitter);
-                         
-                         _stats.lastExpectedRelease = expectedRelease;
-                     }
+                     auto jitterNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         releaseTime - scheduledRelease).count();
+                     _releaseJitterNs.record(jitterNs);
                  }
                  
                  // Execute the service
-                 auto startTime = std::chrono::steady_clock::now();
-                 _doService();
-                 auto endTime = std::chrono::steady_clock::now();
+                 auto scheduledNs = scheduledRelease.time_since_epoch().count();
+                 TraceMarker::jobStart(_id, scheduledNs);
+                 auto startTime = RtClock::now();
+                 doService();
+                 auto endTime = RtClock::now();
+                 TraceMarker::jobEnd(_id, scheduledNs);
                  
+                 // Stages are recorded after the job so they stay off the release path
+                 if (record.handler != std::chrono::steady_clock::time_point{}) {
+                     _releaseStages.record(scheduledRelease, record.handler, record.post, releaseTime, startTime);
+                 }
+ 
                  // Record execution time statistics
                  {
-                     std::lock_guard<std::mutex> lock(_statsMutex);
-                     
+                     _executionTimeNs.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         endTime - startTime).count());
+                     _responseTimeNs.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         endTime - scheduledRelease).count());
+ 
                      double executionTime = std::chrono::duration_cast<std::chrono::microseconds>(
                          endTime - startTime).count() / 1000.0; // Convert to ms
                      
@@ -224,18 +534,33 @@
                      _stats.maxExecutionTime = std::max(_stats.maxExecutionTime, executionTime);
                      _stats.totalExecutionTime += executionTime;
                      
-                     // Check for deadline miss (deadline = period)
+                     // Check for deadline miss (relative to the scheduled release)
                      double responseTime = std::chrono::duration_cast<std::chrono::microseconds>(
-                         endTime - releaseTime).count() / 1000.0; // Convert to ms
+                         endTime - scheduledRelease).count() / 1000.0; // Convert to ms
                      
-                     if (responseTime > _period) {
+                     if (responseTime > _deadlineMs()) {
                          _stats.deadlineMisses++;
-                         double lateness = responseTime - _period;
+                         double lateness = responseTime - _deadlineMs();
                          _stats.maxLateness = std::max(_stats.maxLateness, lateness);
                      }
                      
+                     _stats.missedReleases += missed;
                      _stats.executionCount++;
                  }
+ 
+                 // Make this job visible to statistics() readers
+                 _publishedStats.store(_stats);
+ 
+                 if (_traceRing != nullptr) {
+                     uint32_t flags = _sleepSpin ? JobEvent::SelfTimed : 0;
+                     if (endTime - scheduledRelease > _deadline) flags |= JobEvent::DeadlineMiss;
+                     if (missed > 0) flags |= JobEvent::MissedRelease;
+                     _traceRing->push(JobEvent{
+                         scheduledNs,
+                         startTime.time_since_epoch().count(),
+                         endTime.time_since_epoch().count(),
+                         0, static_cast<uint16_t>(sched_getcpu()), flags});
+                 }
              }
          }
      }
@@ -247,7 +572,22 @@
  class Sequencer
  {
  public:
-     Sequencer() {
+     // How services are released:
+     //  TimerThread - one SIGEV_THREAD POSIX timer per service (glibc spawns a
+     //                helper thread at SCHED_OTHER for every expiry)
+     //  Dispatcher  - one SCHED_FIFO thread at maximum priority that sleeps with
+     //                clock_nanosleep(TIMER_ABSTIME) until the earliest release
+     enum class ReleaseMode { TimerThread, Dispatcher };
+ 
+     // What startServices() does when the services with a timing model
+     // (Service::setTiming) fail response-time analysis on their core:
+     // nothing, log a warning and start anyway, or release nothing
+     enum class Admission { Off, Warn, Refuse };
+ 
+     Sequencer(ReleaseMode mode = ReleaseMode::Dispatcher, int dispatcherAffinity = -1) :
+         _releaseMode(mode),
+         _dispatcherAffinity(dispatcherAffinity)
+     {
          // Initialize syslog
          openlog("rt_services", LOG_PID | LOG_CONS, LOG_USER);
      }
@@ -256,20 +596,156 @@
          closelog();
      }
  
+     // Returns the new service so it can be configured before startServices()
      template<typename... Args>
-     void addService(Args&&... args)
+     Service& addService(Args&&... args)
      {
          // Add the new service to the services list,
          // We use push_back with a unique_ptr to avoid moving Service objects
          _services.push_back(std::make_unique<Service>(std::forward<Args>(args)...));
+         _services.back()->setId(static_cast<uint16_t>(_services.size() - 1));
+         return *_services.back();
+     }
+ 
+     // Stream every job of every service added so far to path (see
+     // TraceRecorder.hpp). Call after addService and before startServices.
+     void enableTrace(const std::string& path, TraceRecorder::Config config = {})
+     {
+         _trace = std::make_unique<TraceRecorder>(path, config);
+         for (auto& service : _services) {
+             service->setTraceRing(&_trace->addRing());
+         }
+     }
+ 
+     void setAdmission(Admission admission) {
+         _admission = admission;
      }
  
-     void startServices()
+     // Response-time analysis of every core's services, highest priority
+     // first. SCHED_FIFO does not preempt between equal priorities, so a
+     // service sharing its priority is analysed with every peer counted as
+     // higher priority. Prints the analysis if verbose or infeasible;
+     // returns false if any service can miss.
+     bool checkSchedulability(bool verbose = true) const
      {
-         syslog(LOG_INFO, "Sequencer starting services");
+         size_t unmodelled = 0;
+         bool feasible = true;
+         for (auto& [core, services] : _servicesByCore(unmodelled)) {
+             auto tasks = _timings(services);
+             auto priorities = _priorities(services);
+             auto analysis = Schedulability::analyze(tasks, priorities);
+             feasible = feasible && analysis.feasible;
+             if (!verbose && analysis.feasible) continue;
+ 
+             printf("Schedulability, core %d: U=%.3f, %s, WCETs x%.3f at the limit\n", core,
+                    Schedulability::utilization(tasks), analysis.feasible ? "feasible" : "NOT FEASIBLE",
+                    Schedulability::criticalScalingFactor(tasks, priorities));
+             for (size_t i = 0; i < tasks.size(); ++i) {
+                 bool shared = (i > 0 && priorities[i - 1] == priorities[i]) ||
+                               (i + 1 < tasks.size() && priorities[i + 1] == priorities[i]);
+                 printf("  service %u (prio %u%s): C=%.3f T=%.3f D=%.3f J=%.3f B=%.3f ms -> ",
+                        services[i]->getId(), services[i]->getPriority(), shared ? ", shared" : "",
+                        tasks[i].wcetNs / 1e6,
+                        tasks[i].periodNs / 1e6, tasks[i].deadline() / 1e6, tasks[i].jitterNs / 1e6,
+                        tasks[i].blockingNs / 1e6);
+                 if (analysis.responseNs[i] == Schedulability::Unschedulable) {
+                     printf("can miss its deadline\n");
+                 } else {
+                     printf("R=%.3f ms, C up to %.3f ms\n", analysis.responseNs[i] / 1e6,
+                            Schedulability::maxWcet(tasks, i, priorities) / 1e6);
+                 }
+             }
+         }
+         if (verbose && unmodelled > 0) {
+             printf("Schedulability: %zu service(s) without a WCET not analysed\n", unmodelled);
+         }
+         return feasible;
+     }
+ 
+     // How close each modelled service ran to the largest WCET its core
+     // tolerates (Schedulability::maxWcet, the other services at their
+     // model WCETs): measured maximum execution time against that limit
+     void printSensitivity() const
+     {
+         size_t unmodelled = 0;
+         auto cores = _servicesByCore(unmodelled);
+         if (cores.empty()) return;
+ 
+         printf("\n=== WCET Sensitivity (measured vs tolerable) ===\n");
+         for (auto& [core, services] : cores) {
+             auto tasks = _timings(services);
+             auto priorities = _priorities(services);
+             printf("Core %d: WCETs x%.3f at the limit\n", core,
+                    Schedulability::criticalScalingFactor(tasks, priorities));
+             printf("  %-8s %5s %10s %10s %10s %10s %6s\n", "service", "prio", "model ms", "limit ms",
+                    "max ms", "slack ms", "used");
+             for (size_t i = 0; i < tasks.size(); ++i) {
+                 // Both in ns: the ms statistics are truncated to whole us
+                 int64_t limit = Schedulability::maxWcet(tasks, i, priorities);
+                 const LatencyHistogram& executionTime = services[i]->executionTimeHistogram();
+                 int64_t measured = executionTime.count() > 0 ? executionTime.max() : 0;
+                 printf("  %-8u %5u %10.3f %10.3f %10.3f %10.3f %5.0f%%%s\n", services[i]->getId(),
+                        services[i]->getPriority(), tasks[i].wcetNs / 1e6, limit / 1e6, measured / 1e6,
+                        (limit - measured) / 1e6, limit > 0 ? 100.0 * measured / limit : 0.0,
+                        measured > limit ? "  OVER LIMIT" : measured > tasks[i].wcetNs ? "  over model" : "");
+             }
+         }
+     }
+ 
+     // Returns false, releasing nothing, if admission is Refuse and the
+     // service set is not schedulable
+     bool startServices()
+     {
+         if (_admission != Admission::Off && !checkSchedulability(false)) {
+             if (_admission == Admission::Refuse) {
+                 syslog(LOG_ERR, "Sequencer refusing infeasible service set");
+                 return false;
+             }
+             syslog(LOG_WARNING, "Sequencer starting an infeasible service set");
+         }
+ 
+         syslog(LOG_INFO, "Sequencer starting services (%s)", releaseModeName());
          
+         if (_trace && !_trace->start()) {
+             for (auto& service : _services) {
+                 service->setTraceRing(nullptr);
+             }
+             _trace.reset();
+         }
+ 
+         // All services share one epoch; the first release is one period later
+         auto epoch = RtClock::now();
+         for (auto& service : _services) {
+             service->setReleaseEpoch(epoch);
+         }
+ 
+         // Self-timed (sleep-then-spin) services release themselves
+         bool anyReleased = false;
+         for (auto& service : _services) {
+             if (service->isSelfTimed()) {
+                 service->startSelfTimed();
+             } else {
+                 anyReleased = true;
+             }
+         }
+ 
+         if (_releaseMode == ReleaseMode::Dispatcher) {
+             _nextRelease.clear();
+             for (auto& service : _services) {
+                 _nextRelease.push_back(service->isSelfTimed()
+                     ? std::chrono::steady_clock::time_point::max()
+                     : epoch + service->getPeriod());
+             }
+             if (anyReleased) {
+                 _dispatcher = std::jthread([this](std::stop_token stopToken) { _dispatch(stopToken); });
+             }
+             return true;
+         }
+ 
          // Create and start timers for each service
          for (size_t i = 0; i < _services.size(); ++i) {
+             if (_services[i]->isSelfTimed()) continue;
+ 
              timer_t timerId;
              struct sigevent sev;
              struct itimerspec its;
@@ -280,53 +756,261 @@
              sev.sigev_notify_function = Sequencer::timerHandler;
              sev.sigev_value.sival_ptr = _services[i].get();
              
-             // Create the timer
-             if (timer_create(CLOCK_REALTIME, &sev, &timerId) == -1) {
+             // Create the timer on the same clock as the release epoch
+             if (timer_create(CLOCK_MONOTONIC, &sev, &timerId) == -1) {
                  syslog(LOG_ERR, "Failed to create timer for service %zu", i);
                  continue;
              }
              
              _services[i]->setTimerId(timerId);
              
-             // Configure the timer period
-             uint32_t period_ms = _services[i]->getPeriod();
-             its.it_value.tv_sec = period_ms / 1000;
-             its.it_value.tv_nsec = (period_ms % 1000) * 1000000;
-             its.it_interval = its.it_value;
+             // Configure the timer period, first expiry at epoch + period
+             auto period_ns = _services[i]->getPeriod().count();
+             its.it_value = toTimespec(epoch + _services[i]->getPeriod());
+             its.it_interval.tv_sec = period_ns / 1000000000;
+             its.it_interval.tv_nsec = period_ns % 1000000000;
              
              // Start the timer
-             if (timer_settime(timerId, 0, &its, nullptr) == -1) {
+             if (timer_settime(timerId, TIMER_ABSTIME, &its, nullptr) == -1) {
                  syslog(LOG_ERR, "Failed to start timer for service %zu", i);
              }
          }
+         return true;
      }
  
-     void stopServices()
+     // printSummary = false leaves the report to the caller (see printSummary)
+     void stopServices(bool printSummary = true)
      {
          syslog(LOG_INFO, "Sequencer stopping services");
          
+         // Stop the release source first so no release races with stop()
+         if (_dispatcher.joinable()) {
+             _dispatcher.request_stop();
+             _dispatcher.join();
+         }
+ 
          // Stop and delete all timers
          for (auto& service : _services) {
-             timer_delete(service->getTimerId());
+             if (_releaseMode == ReleaseMode::TimerThread && !service->isSelfTimed()) {
+                 timer_delete(service->getTimerId());
+             }
              service->stop();
          }
          
-         // Wait for all services to finish
-         // (The jthread destructor will join automatically)
-         
-         // Print statistics for all services
-         printf("\n=== FINAL SERVICE STATISTICS SUMMARY ===\n");
+         // Wait for all services to finish, so their last job events are
+         // in the rings before the trace is drained for the last time
+         for (auto& service : _services) {
+             service->join();
+         }
+ 
+         if (_trace) {
+             _trace->stop();
+         }
+ 
+         if (printSummary) {
+             this->printSummary();
+         }
+     }
+ 
+     // Print statistics for all services
+     void printSummary() const
+     {
+         printf("\n=== FINAL SERVICE STATISTICS SUMMARY (%s release) ===\n", releaseModeName());
+         printf("Timestamps: %s", RtClock::sourceName());
+         if (RtClock::usingCounter()) {
+             printf(" at %.3f MHz, %lu re-bases", RtClock::counterHz() / 1e6, RtClock::rebaseCount());
+         }
+         printf("\n");
+         if (_trace) {
+             printf("Trace: %lu jobs, %lu dropped, %lu bytes (%.1f bytes/job), %lu rotations\n",
+                    _trace->eventsWritten(), _trace->eventsDropped(), _trace->bytesWritten(),
+                    _trace->eventsWritten() ? double(_trace->bytesWritten()) / _trace->eventsWritten() : 0.0,
+                    _trace->rotations());
+         }
          for (const auto& service : _services) {
              service->printStatistics();
          }
+ 
+         // Same distributions merged over every service
+         auto merged = [this](const LatencyHistogram& (Service::*histogram)() const) {
+             auto all = std::make_unique<LatencyHistogram>();
+             for (const auto& service : _services) {
+                 all->merge(((*service).*histogram)());
+             }
+             return all;
+         };
+         printf("\n=== All Services Latency Percentiles ===\n");
+         LatencyHistogram::printPercentileHeader();
+         merged(&Service::releaseJitterHistogram)->printPercentileRow("Release Jitter");
+         merged(&Service::executionTimeHistogram)->printPercentileRow("Execution Time");
+         merged(&Service::responseTimeHistogram)->printPercentileRow("Response Time");
+         auto stages = std::make_unique<ReleaseStages>();
+         for (const auto& service : _services) {
+             stages->merge(service->releaseStages());
+         }
+         if (stages->expiryToHandler.count() > 0) {
+             stages->printRows();
+         }
+         printSensitivity();
+     }
+ 
+     // Merge this run's latency histograms into the file at path (created if
+     // missing), so repeated runs accumulate one distribution per service.
+     // Services are keyed by index, period and priority.
+     bool saveHistograms(const char* path) const
+     {
+         std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+         auto histogram = [&histograms](const std::string& name) -> LatencyHistogram& {
+             auto& slot = histograms[name];
+             if (!slot) slot = std::make_unique<LatencyHistogram>();
+             return *slot;
+         };
+ 
+         if (FILE* in = fopen(path, "r")) {
+             std::string name;
+             LatencyHistogram block;
+             while (block.load(in, &name)) {
+                 histogram(name).merge(block);
+                 block.reset();
+             }
+             fclose(in);
+         }
+ 
+         for (size_t i = 0; i < _services.size(); ++i) {
+             const Service& service = *_services[i];
+             std::string key = "service" + std::to_string(i) + "_"
+                 + std::to_string(service.getPeriod().count()) + "ns_prio"
+                 + std::to_string(service.getPriority());
+             histogram(key + ".release_jitter").merge(service.releaseJitterHistogram());
+             histogram(key + ".execution_time").merge(service.executionTimeHistogram());
+             histogram(key + ".response_time").merge(service.responseTimeHistogram());
+         }
+ 
+         FILE* out = fopen(path, "w");
+         if (out == nullptr) {
+             syslog(LOG_ERR, "Failed to open histogram file %s: %s", path, strerror(errno));
+             return false;
+         }
+         bool ok = true;
+         for (const auto& [name, h] : histograms) {
+             ok = h->save(out, name) && ok;
+         }
+         return fclose(out) == 0 && ok;
+     }
+ 
+     const char* releaseModeName() const {
+         return _releaseMode == ReleaseMode::Dispatcher ? "dispatcher" : "timer-thread";
      }
  
  private:
+     // Declared before _services so the rings outlive the service threads
+     std::unique_ptr<TraceRecorder> _trace;
      std::vector<std::unique_ptr<Service>> _services;
+     ReleaseMode _releaseMode;
+     int _dispatcherAffinity;
+     Admission _admission{Admission::Warn};
+     std::vector<std::chrono::steady_clock::time_point> _nextRelease;
+     std::jthread _dispatcher;
      
      static void timerHandler(union sigval sv) {
          auto* service = static_cast<Service*>(sv.sival_ptr);
-         service->release();
+         auto scheduled = service->release();
+         TraceMarker::release(service->getId(), scheduled.time_since_epoch().count());
+         RtClock::verifyIfDue();
+     }
+ 
+     // Services with a timing model, by core, highest priority first;
+     // counts the others in unmodelled
+     std::map<int, std::vector<const Service*>> _servicesByCore(size_t& unmodelled) const
+     {
+         std::map<int, std::vector<const Service*>> cores;
+         for (const auto& service : _services) {
+             if (service->hasTiming()) {
+                 cores[service->getAffinity()].push_back(service.get());
+             } else {
+                 unmodelled++;
+             }
+         }
+         for (auto& [core, services] : cores) {
+             std::stable_sort(services.begin(), services.end(), [](const Service* a, const Service* b) {
+                 return a->getPriority() > b->getPriority();
+             });
+         }
+         return cores;
+     }
+ 
+     static std::vector<TaskTiming> _timings(const std::vector<const Service*>& services)
+     {
+         std::vector<TaskTiming> tasks;
+         for (const Service* service : services) {
+             tasks.push_back(service->timing());
+         }
+         return tasks;
+     }
+ 
+     static std::vector<int> _priorities(const std::vector<const Service*>& services)
+     {
+         std::vector<int> priorities;
+         for (const Service* service : services) {
+             priorities.push_back(service->getPriority());
+         }
+         return priorities;
+     }
+ 
+     static timespec toTimespec(std::chrono::steady_clock::time_point tp) {
+         auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+         return timespec{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+     }
+ 
+     // Release thread: sleeps until the earliest next release of any service,
+     // releases every service that is due and moves its release forward.
+     void _dispatch(std::stop_token stopToken)
+     {
+         if (_dispatcherAffinity >= 0) {
+             cpu_set_t cpuset;
+             CPU_ZERO(&cpuset);
+             CPU_SET(_dispatcherAffinity, &cpuset);
+             int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+             if (result != 0) {
+                 syslog(LOG_ERR, "Failed to set dispatcher affinity: %s", strerror(result));
+             }
+         }
+ 
+         struct sched_param param;
+         param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+         int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+         if (result != 0) {
+             syslog(LOG_ERR, "Failed to set dispatcher scheduling parameters: %s", strerror(result));
+         }
+ 
+         while (!stopToken.stop_requested() && !_nextRelease.empty()) {
+             auto wakeup = toTimespec(*std::min_element(_nextRelease.begin(), _nextRelease.end()));
+             while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR) {}
+             
+             if (stopToken.stop_requested()) break;
+ 
+             auto now = RtClock::now();
+             for (size_t i = 0; i < _services.size(); ++i) {
+                 if (_nextRelease[i] > now) continue;
+ 
+                 // If we fell behind, skip the releases we can no longer
+                 // make; the service counts them as missed
+                 auto scheduled = _nextRelease[i];
+                 auto period = _services[i]->getPeriod();
+                 uint32_t skipped = 0;
+                 _nextRelease[i] += period;
+                 while (_nextRelease[i] <= now) {
+                     _nextRelease[i] += period;
+                     skipped++;
+                 }
+ 
+                 _services[i]->release(scheduled, now, skipped);
+                 TraceMarker::release(_services[i]->getId(), scheduled.time_since_epoch().count());
+             }
+ 
+             // Re-check the timestamp counter against CLOCK_MONOTONIC now and then
+             RtClock::verifyIfDue();
+         }
      }
  };
  
\ No newline at end of file
@@ -0,0 +1,142 @@
+/*
+ * Random task-set parameters for schedulability studies.
+ *
+ * Utilizations are drawn uniformly from the simplex of n values with a
+ * given sum:
+ *   uuniFast()      Bini & Buttazzo's UUniFast, O(n)
+ *   randFixedSum()  Stafford's RandFixedSum (as used by Emberson, Stafford
+ *                   & Davis), O(n^2), which also bounds every value by a
+ *                   cap; without a binding cap it draws from the same
+ *                   distribution as UUniFast
+ * and periods log-uniformly, so every decade of periods is equally likely.
+ *
+ * All buffers are sized by the constructor; drawing a set does not
+ * allocate, so one generator per thread runs without contention.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+class TaskSetGenerator
+{
+public:
+    TaskSetGenerator(size_t tasks, uint64_t seed)
+        : _random(seed), _utilizations(tasks), _w(tasks * (tasks + 1)), _t(tasks * tasks), _s1(tasks),
+          _s2(tasks)
+    {
+    }
+
+    size_t tasks() const
+    {
+        return _utilizations.size();
+    }
+
+    void reseed(uint64_t seed)
+    {
+        _random.seed(seed);
+    }
+
+    // Uniform in [low, high)
+    double uniform(double low = 0.0, double high = 1.0)
+    {
+        return low + (high - low) * std::generate_canonical<double, 53>(_random);
+    }
+
+    // Log-uniform in [low, high]
+    int64_t logUniform(int64_t low, int64_t high)
+    {
+        double exponent = uniform(std::log(static_cast<double>(low)), std::log(static_cast<double>(high)));
+        return std::clamp(static_cast<int64_t>(std::exp(exponent)), low, high);
+    }
+
+    // tasks() utilizations summing to total
+    const std::vector<double>& uuniFast(double total)
+    {
+        const size_t n = tasks();
+        double remaining = total;
+        for (size_t i = 0; i + 1 < n; ++i) {
+            double next = remaining * std::pow(uniform(), 1.0 / static_cast<double>(n - i - 1));
+            _utilizations[i] = remaining - next;
+            remaining = next;
+        }
+        _utilizations[n - 1] = remaining;
+        return _utilizations;
+    }
+
+    // tasks() utilizations in [0, cap] summing to total (total <= n cap)
+    const std::vector<double>& randFixedSum(double total, double cap)
+    {
+        const size_t n = tasks();
+        if (n == 1) {
+            _utilizations[0] = total;
+            return _utilizations;
+        }
+
+        // On the unit cube: n values in [0, 1] summing to s, k <= s <= k+1.
+        // The simplex slice is split into sub-simplices; w(i, j) is the
+        // volume of the i-dimensional ones and t(i, j) the probability of
+        // stepping down a layer when drawing dimension i (1-based below).
+        double s = total / cap;
+        const auto k = static_cast<size_t>(std::clamp(std::floor(s), 0.0, static_cast<double>(n - 1)));
+        s = std::clamp(s, static_cast<double>(k), static_cast<double>(k + 1));
+        for (size_t c = 1; c <= n; ++c) {
+            _s1[c - 1] = s - static_cast<double>(k) + static_cast<double>(c) - 1.0;
+            _s2[c - 1] = static_cast<double>(k + n - c + 1) - s;
+        }
+
+        auto w = [this, n](size_t row, size_t column) -> double& { return _w[(row - 1) * (n + 1) + column - 1]; };
+        auto t = [this, n](size_t row, size_t column) -> double& { return _t[(row - 1) * n + column - 1]; };
+        std::fill(_w.begin(), _w.end(), 0.0);
+        w(1, 2) = std::numeric_limits<double>::max();
+        for (size_t i = 2; i <= n; ++i) {
+            const double size = static_cast<double>(i);
+            for (size_t c = 1; c <= i; ++c) {
+                double up = w(i - 1, c + 1) * _s1[c - 1] / size;
+                double down = w(i - 1, c) * _s2[n - i + c - 1] / size;
+                w(i, c + 1) = up + down;
+                double volume = w(i, c + 1) + std::numeric_limits<double>::denorm_min();
+                t(i - 1, c) = _s2[n - i + c - 1] > _s1[c - 1] ? down / volume : 1.0 - up / volume;
+            }
+        }
+
+        size_t j = k + 1;
+        double sum = 0.0, product = 1.0;
+        for (size_t i = n - 1; i >= 1; --i) {
+            bool step = uniform() <= t(i, j);
+            double scale = std::pow(uniform(), 1.0 / static_cast<double>(i));
+            sum += (1.0 - scale) * product * s / static_cast<double>(i + 1);
+            product *= scale;
+            _utilizations[n - i - 1] = sum + (step ? product : 0.0);
+            if (step) {
+                s -= 1.0;
+                --j;
+            }
+        }
+        _utilizations[n - 1] = sum + product * s;
+
+        // Fisher-Yates: the draw above is ordered by dimension
+        for (size_t i = n - 1; i > 0; --i) {
+            size_t other = std::min(i, static_cast<size_t>(uniform() * static_cast<double>(i + 1)));
+            std::swap(_utilizations[i], _utilizations[other]);
+        }
+        for (double& u : _utilizations) u *= cap;
+        return _utilizations;
+    }
+
+private:
+    std::mt19937_64 _random;
+    std::vector<double> _utilizations;
+
+    // RandFixedSum tables, n x (n + 1) and (n - 1) x n, and the offsets
+    std::vector<double> _w;
+    std::vector<double> _t;
+    std::vector<double> _s1;
+    std::vector<double> _s2;
+};
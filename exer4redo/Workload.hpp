@@ -0,0 +1,255 @@
+/*
+ * Calibrated synthetic job bodies.
+ *
+ * Instead of polling the clock until a target time has passed (which makes
+ * the load itself read the clock thousands of times per job, and makes it
+ * time-based rather than work-based), a Workload measures once at startup
+ * how many iterations of each kernel fit in a microsecond, and run() then
+ * executes a fixed number of iterations with no clock reads in the loop.
+ * An interfered job therefore takes longer, as a real one would.
+ *
+ * Kernels, one iteration each:
+ *   IntegerAlu     64 dependent multiply/xor-shift steps
+ *   FloatingPoint  64 dependent multiply-adds
+ *   MemoryStream   sequential read of 512 bytes of a buffer larger than LLC
+ *   PointerChase   16 dependent loads along a random cycle of cache lines
+ *
+ * Calibrate on the core and at the priority the services will use, with
+ * the CPU frequency fixed (performance governor); calibrationError()
+ * reports how far a run lands from the requested time.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string_view>
+#include <vector>
+#include "RtClock.hpp"
+
+class Workload
+{
+public:
+    enum class Kernel { IntegerAlu, FloatingPoint, MemoryStream, PointerChase };
+
+    static constexpr std::array<Kernel, 4> Kernels = {
+        Kernel::IntegerAlu, Kernel::FloatingPoint, Kernel::MemoryStream, Kernel::PointerChase};
+
+    static const char* name(Kernel kernel)
+    {
+        switch (kernel) {
+        case Kernel::IntegerAlu: return "alu";
+        case Kernel::FloatingPoint: return "fp";
+        case Kernel::MemoryStream: return "stream";
+        case Kernel::PointerChase: return "chase";
+        }
+        return "?";
+    }
+
+    // false if text names no kernel
+    static bool parse(const char* text, Kernel& kernel)
+    {
+        for (Kernel k : Kernels) {
+            if (std::string_view(text) == name(k)) {
+                kernel = k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Buffers for the memory kernels are allocated and touched here, so
+    // run() never page-faults
+    explicit Workload(size_t bufferBytes = size_t{32} << 20)
+        : _stream(bufferBytes / sizeof(uint64_t), 1),
+          _chase(bufferBytes / sizeof(Line))
+    {
+        // Sattolo's shuffle: one cycle through every line, in random order
+        std::vector<uint32_t> order(_chase.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::mt19937 random(12345);
+        for (size_t i = order.size() - 1; i > 0; --i) {
+            std::uniform_int_distribution<size_t> pick(0, i - 1);
+            std::swap(order[i], order[pick(random)]);
+        }
+        for (size_t i = 0; i < order.size(); ++i) {
+            _chase[order[i]].next = order[(i + 1) % order.size()];
+        }
+    }
+
+    // Measures iterations per microsecond of every kernel: the best of
+    // `rounds` runs of about `perRound` each, i.e. the least interfered rate
+    void calibrate(std::chrono::milliseconds perRound = std::chrono::milliseconds(20), int rounds = 3)
+    {
+        for (Kernel kernel : Kernels) {
+            double best = 0.0;
+            for (int round = 0; round < rounds; ++round) {
+                // Grow the batch until it takes at least perRound
+                uint64_t iterations = 64;
+                while (true) {
+                    auto start = RtClock::now();
+                    runIterations(kernel, iterations);
+                    auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(RtClock::now() - start).count();
+                    if (elapsedNs >= perRound.count() * 1000000) {
+                        best = std::max(best, iterations * 1000.0 / elapsedNs);
+                        break;
+                    }
+                    iterations *= 2;
+                }
+            }
+            _iterationsPerUs[_index(kernel)] = best;
+        }
+    }
+
+    bool calibrated() const
+    {
+        return _iterationsPerUs[0] > 0.0;
+    }
+
+    double iterationsPerUs(Kernel kernel) const
+    {
+        return _iterationsPerUs[_index(kernel)];
+    }
+
+    uint64_t iterationsFor(Kernel kernel, std::chrono::nanoseconds work) const
+    {
+        return static_cast<uint64_t>(work.count() * _iterationsPerUs[_index(kernel)] / 1000.0 + 0.5);
+    }
+
+    // About `work` of the kernel on an idle core; requires calibrate()
+    void run(Kernel kernel, std::chrono::nanoseconds work) const
+    {
+        runIterations(kernel, iterationsFor(kernel, work));
+    }
+
+    void runIterations(Kernel kernel, uint64_t iterations) const
+    {
+        switch (kernel) {
+        case Kernel::IntegerAlu: _alu(iterations); break;
+        case Kernel::FloatingPoint: _fp(iterations); break;
+        case Kernel::MemoryStream: _streamRead(iterations); break;
+        case Kernel::PointerChase: _pointerChase(iterations); break;
+        }
+    }
+
+    struct CalibrationError {
+        double meanPercent;    // mean of (measured - requested) / requested
+        double worstPercent;   // largest |error|
+    };
+
+    // Runs `work` `repeats` times and compares the measured times to it
+    CalibrationError calibrationError(Kernel kernel, std::chrono::nanoseconds work, int repeats = 10) const
+    {
+        CalibrationError error{0.0, 0.0};
+        for (int i = 0; i < repeats; ++i) {
+            auto start = RtClock::now();
+            run(kernel, work);
+            double measured = std::chrono::duration<double, std::nano>(RtClock::now() - start).count();
+            double percent = 100.0 * (measured - work.count()) / work.count();
+            error.meanPercent += percent / repeats;
+            if (std::abs(percent) > std::abs(error.worstPercent)) error.worstPercent = percent;
+        }
+        return error;
+    }
+
+    // Rate and calibration error of every kernel at a few job lengths
+    void printCalibration(FILE* out = stdout) const
+    {
+        using namespace std::chrono_literals;
+        const std::chrono::nanoseconds works[] = {100us, 1ms, 10ms};
+        std::fprintf(out, "Workload calibration (error = mean / worst vs requested)\n");
+        std::fprintf(out, "  %-8s %12s", "kernel", "iter/us");
+        for (auto work : works) {
+            std::fprintf(out, " %16ld us", static_cast<long>(work.count() / 1000));
+        }
+        std::fprintf(out, "\n");
+        for (Kernel kernel : Kernels) {
+            std::fprintf(out, "  %-8s %12.3f", name(kernel), iterationsPerUs(kernel));
+            for (auto work : works) {
+                auto error = calibrationError(kernel, work);
+                std::fprintf(out, "   %+6.1f%% / %+6.1f%%", error.meanPercent, error.worstPercent);
+            }
+            std::fprintf(out, "\n");
+        }
+    }
+
+private:
+    struct alignas(64) Line {
+        uint32_t next;
+    };
+
+    static constexpr size_t StreamWordsPerIteration = 64;   // 512 bytes
+    static constexpr int ChaseLoadsPerIteration = 16;
+
+    std::vector<uint64_t> _stream;
+    std::vector<Line> _chase;
+    std::array<double, Kernels.size()> _iterationsPerUs{};
+
+    // Per-thread position, so consecutive short jobs keep walking the
+    // buffers instead of re-reading the same cached lines
+    static inline thread_local size_t _streamCursor = 0;
+    static inline thread_local uint32_t _chaseCursor = 0;
+
+    static size_t _index(Kernel kernel)
+    {
+        return static_cast<size_t>(kernel);
+    }
+
+    template <typename T>
+    static void _keep(T value)
+    {
+        asm volatile("" : : "g"(value) : "memory");
+    }
+
+    static void _alu(uint64_t iterations)
+    {
+        uint64_t x = 0x9E3779B97F4A7C15ull;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            for (int step = 0; step < 64; ++step) {
+                x = x * 6364136223846793005ull + 1442695040888963407ull;
+                x ^= x >> 29;
+            }
+            _keep(x);
+        }
+    }
+
+    static void _fp(uint64_t iterations)
+    {
+        double y = 1.0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            for (int step = 0; step < 64; ++step) {
+                y = y * 0.999999999 + 1e-9;
+            }
+            _keep(y);
+        }
+    }
+
+    void _streamRead(uint64_t iterations) const
+    {
+        size_t cursor = _streamCursor;
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < iterations; ++i) {
+            if (cursor + StreamWordsPerIteration > _stream.size()) cursor = 0;
+            for (size_t w = 0; w < StreamWordsPerIteration; ++w) sum += _stream[cursor + w];
+            cursor += StreamWordsPerIteration;
+            _keep(sum);
+        }
+        _streamCursor = cursor;
+    }
+
+    void _pointerChase(uint64_t iterations) const
+    {
+        uint32_t cursor = _chaseCursor % _chase.size();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            for (int load = 0; load < ChaseLoadsPerIteration; ++load) cursor = _chase[cursor].next;
+            _keep(cursor);
+        }
+        _chaseCursor = cursor;
+    }
+};
@@ -0,0 +1,84 @@
+/*
+ * Dispatch overhead of the job body storage used by Service:
+ *   direct          - callable type known to the loop (fully inlinable); what
+ *                     Service does, its job loop is instantiated per callable
+ *   InplaceFunction - inline storage, one indirect call (sk_exer4's ServiceFunction)
+ *   std::function   - previous Service storage, heap for larger captures
+ *
+ * Build: make bench_callable
+ * Run:   ./bench_callable [calls]
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include "InplaceFunction.hpp"
+
+static uint64_t allocations = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Same shape as a Service job: small state captured by value plus a
+// reference to something the job updates
+struct Job {
+    uint64_t* counter;
+    uint64_t a, b, c;
+    void operator()() { *counter += a + b + c; }
+};
+
+template <typename F>
+__attribute__((noinline)) void dispatchLoop(F& job, uint64_t calls) {
+    for (uint64_t i = 0; i < calls; ++i) job();
+}
+
+template <typename Make>
+void report(const char* name, uint64_t calls, Make make) {
+    uint64_t counter = 0;
+
+    // Construction: what Service construction pays, including allocations
+    uint64_t allocsBefore = allocations;
+    auto c0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100000; ++i) {
+        auto job = make(&counter);
+        (void)job;
+    }
+    auto c1 = std::chrono::steady_clock::now();
+    uint64_t allocsPer100k = allocations - allocsBefore;
+
+    // Dispatch: what _provideService pays per job
+    auto job = make(&counter);
+    auto d0 = std::chrono::steady_clock::now();
+    dispatchLoop(job, calls);
+    auto d1 = std::chrono::steady_clock::now();
+
+    double constructNs = std::chrono::duration<double, std::nano>(c1 - c0).count() / 100000;
+    double callNs = std::chrono::duration<double, std::nano>(d1 - d0).count() / calls;
+    std::printf("%-16s %10.2f %12.2f %12.2f   (check %lu)\n",
+                name, callNs, constructNs, allocsPer100k / 100000.0, counter);
+}
+
+int main(int argc, char* argv[]) {
+    uint64_t calls = 200000000;
+    if (argc > 1) {
+        calls = std::strtoull(argv[1], nullptr, 10);
+        if (calls == 0) {
+            std::fprintf(stderr, "Usage: %s [calls]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("%-16s %10s %12s %12s\n", "storage", "ns/call", "ns/construct", "allocs/obj");
+    report("direct", calls, [](uint64_t* c) { return Job{c, 1, 2, 3}; });
+    report("InplaceFunction", calls, [](uint64_t* c) { return InplaceFunction<void(void), 64>(Job{c, 1, 2, 3}); });
+    report("std::function", calls, [](uint64_t* c) { return std::function<void(void)>(Job{c, 1, 2, 3}); });
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Cost of one timestamp and agreement with CLOCK_MONOTONIC:
+ *   steady_clock::now()  - clock_gettime(CLOCK_MONOTONIC) through the vDSO
+ *   RtClock::now()       - calibrated cycle counter (TSC / CNTVCT_EL0)
+ *
+ * Build: make bench_clock
+ * Run:   ./bench_clock [seconds_to_track_drift]
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "RtClock.hpp"
+
+template <typename Now>
+double nsPerCall(Now now) {
+    constexpr int Calls = 10000000;
+    int64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < Calls; ++i) {
+        sink += now().time_since_epoch().count();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if (sink == 42) std::printf(" ");
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / Calls;
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = 5;
+    if (argc > 1) {
+        seconds = std::atoi(argv[1]);
+        if (seconds <= 0) {
+            std::fprintf(stderr, "Usage: %s [seconds_to_track_drift]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    RtClock::init();
+    std::printf("RtClock source: %s", RtClock::sourceName());
+    if (RtClock::usingCounter()) std::printf(" (%.3f MHz)", RtClock::counterHz() / 1e6);
+    std::printf("\n\n");
+
+    std::printf("%-22s %8s\n", "clock", "ns/call");
+    std::printf("%-22s %8.2f\n", "steady_clock::now()", nsPerCall([] { return std::chrono::steady_clock::now(); }));
+    std::printf("%-22s %8.2f\n", "RtClock::now()", nsPerCall([] { return RtClock::now(); }));
+
+    std::printf("\n%6s %14s %8s\n", "t (s)", "error (ns)", "re-bases");
+    for (int t = 1; t <= seconds; ++t) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        auto mono0 = std::chrono::steady_clock::now();
+        auto rt = RtClock::now();
+        auto mono1 = std::chrono::steady_clock::now();
+        auto error = rt - (mono0 + (mono1 - mono0) / 2);
+        RtClock::verify();
+        std::printf("%6d %14ld %8lu\n", t,
+                    static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(error).count()),
+                    RtClock::rebaseCount());
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * EDF processor-demand test: QPA (EdfSchedulability::feasible) against
+ * brute force, which checks h(d) <= d at every absolute deadline d up to
+ * the hyperperiod plus the largest deadline.
+ *
+ * Constrained-deadline sets: UUniFast utilizations at -u, periods drawn
+ * from the divisors of the hyperperiod -H (so it stays bounded), and
+ * D uniform in [C + d (T - C), T]. Both tests must agree on every set.
+ *
+ * Build: make bench_edf
+ * Run:   ./bench_edf [-u utilization] [-d min_deadline_ratio] [-H hyperperiod_ms] [-t trials] [-s seed] [sizes...]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+#include "EdfSchedulability.hpp"
+#include "TaskSetGenerator.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int64_t Ms = 1000000;
+
+static std::vector<TaskTiming> randomTaskSet(TaskSetGenerator& generator, double utilization, double minDeadline,
+                                             const std::vector<int64_t>& periods) {
+    std::vector<TaskTiming> tasks;
+    for (double u : generator.uuniFast(utilization)) {
+        auto pick = std::min(periods.size() - 1, static_cast<size_t>(generator.uniform() * periods.size()));
+        int64_t period = periods[pick];
+        int64_t wcet = std::max<int64_t>(1, std::llround(u * static_cast<double>(period)));
+        auto deadline = wcet + std::llround((period - wcet) * generator.uniform(minDeadline, 1.0));
+        tasks.push_back(TaskTiming{wcet, period, std::clamp<int64_t>(deadline, wcet, period)});
+    }
+    return tasks;
+}
+
+// Every deadline up to H + max D; deadlines counts the h(d) evaluations
+static bool bruteForceFeasible(const std::vector<TaskTiming>& tasks, int64_t hyperperiod, int64_t& deadlines) {
+    deadlines = 0;
+    if (Schedulability::utilization(tasks) > 1.0) return false;
+    int64_t horizon = hyperperiod;
+    for (const auto& task : tasks) horizon = std::max(horizon, hyperperiod + task.deadline());
+    for (const auto& task : tasks) {
+        for (int64_t d = task.deadline(); d <= horizon; d += task.periodNs) {
+            ++deadlines;
+            if (EdfSchedulability::demand(tasks, d) > d) return false;
+        }
+    }
+    return true;
+}
+
+template <typename F>
+static double secondsOf(F&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void printTime(double seconds) {
+    if (seconds < 1e-3) std::printf(" %10.2f us", seconds * 1e6);
+    else if (seconds < 1.0) std::printf(" %10.2f ms", seconds * 1e3);
+    else std::printf(" %10.2f s ", seconds);
+}
+
+int main(int argc, char* argv[]) {
+    double utilization = 0.95;
+    double minDeadline = 0.5;
+    int64_t hyperperiodMs = 3600;
+    int trials = 20;
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "u:d:H:t:s:")) != -1) {
+        switch (opt) {
+        case 'u': utilization = std::atof(optarg); break;
+        case 'd': minDeadline = std::clamp(std::atof(optarg), 0.0, 1.0); break;
+        case 'H': hyperperiodMs = std::max(1ll, std::atoll(optarg)); break;
+        case 't': trials = std::max(1, std::atoi(optarg)); break;
+        case 's': seed = std::strtoull(optarg, nullptr, 10); break;
+        default:
+            std::fprintf(stderr,
+                         "Usage: %s [-u utilization] [-d min_deadline_ratio] [-H hyperperiod_ms] [-t trials] "
+                         "[-s seed] [sizes...]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    std::vector<size_t> sizes;
+    for (int i = optind; i < argc; ++i) sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {5, 10, 20, 50, 100};
+
+    std::vector<int64_t> periods;
+    for (int64_t divisor = 1; divisor <= hyperperiodMs; ++divisor) {
+        if (hyperperiodMs % divisor == 0) periods.push_back(divisor * Ms);
+    }
+
+    std::printf("EDF, U=%.2f, D in [C + %.2f (T - C), T], periods dividing %ld ms (%zu), mean of %d sets\n",
+                utilization, minDeadline, hyperperiodMs, periods.size(), trials);
+    std::printf("%7s %13s %13s %13s %13s %9s\n", "tasks", "brute", "qpa", "deadlines", "qpa steps", "speedup");
+
+    for (size_t n : sizes) {
+        TaskSetGenerator generator(n, seed + n);
+        double brute = 0.0, qpa = 0.0;
+        int64_t deadlines = 0, steps = 0;
+        int feasible = 0, agreed = 0;
+        for (int trial = 0; trial < trials; ++trial) {
+            auto tasks = randomTaskSet(generator, utilization, minDeadline, periods);
+            bool bruteFeasible = false, qpaFeasible = false;
+            int64_t checked = 0, walked = 0;
+            brute += secondsOf([&] { bruteFeasible = bruteForceFeasible(tasks, hyperperiodMs * Ms, checked); });
+            qpa += secondsOf([&] { qpaFeasible = EdfSchedulability::feasible(tasks, &walked); });
+            deadlines += checked;
+            steps += walked;
+            feasible += qpaFeasible;
+            agreed += qpaFeasible == bruteFeasible;
+        }
+
+        std::printf("%7zu", n);
+        printTime(brute / trials);
+        printTime(qpa / trials);
+        std::printf(" %13ld %13ld %8.1fx  %d/%d feasible", deadlines / trials, steps / trials,
+                    brute / std::max(qpa, 1e-12), feasible, trials);
+        if (agreed != trials) std::printf("  MISMATCH %d/%d", agreed, trials);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+/*
+ * Jitter and response time of a Sequencer service set under contention.
+ *
+ * Runs the same rate-monotonic service set (Workload job bodies, all pinned
+ * to one core) once without interference as the baseline, then once per
+ * co-runner from Interference.hpp and placement:
+ *   same     co-runner on the services' core (competes for the CPU, shares
+ *            every cache level)
+ *   sibling  co-runner on the SMT sibling of that core (shares the core's
+ *            execution units and caches, not the CPU time)
+ *   <cpu>    co-runner on an explicit core (shares LLC / memory bandwidth)
+ * Each scenario prints per-service release jitter and response-time
+ * percentiles; the summary compares p99 and max against the baseline.
+ *
+ * Build: make bench_interference
+ * Run:   ./bench_interference [-s period_ms:wcet_us,...] [-w alu|fp|stream|chase]
+ *                             [-r corunner,...] [-p same|sibling|cpu,...] [-n count]
+ *                             [-d seconds] [-a cpu] [-P corunner_priority]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Interference.hpp"
+#include "Sequencer.hpp"
+#include "Workload.hpp"
+
+struct ServiceSpec {
+    std::chrono::milliseconds period;
+    std::chrono::microseconds wcet;
+};
+
+struct Bench {
+    std::vector<ServiceSpec> services;
+    Workload::Kernel kernel = Workload::Kernel::IntegerAlu;
+    std::chrono::seconds duration{3};
+    int cpu = 0;
+    int coRunners = 1;
+    int coRunnerPriority = 0;
+};
+
+struct Scenario {
+    std::string name;
+    std::vector<CoRunner::Kind> kinds;   // empty = baseline
+    int cpu = -1;
+};
+
+struct ServiceResult {
+    LatencyHistogram jitter;
+    LatencyHistogram response;
+    uint64_t deadlineMisses = 0;
+    uint64_t missedReleases = 0;
+};
+
+using Results = std::vector<std::unique_ptr<ServiceResult>>;
+
+static Results runScenario(const Bench& bench, const Workload& workload, const Scenario& scenario) {
+    int maxPriority = sched_get_priority_max(SCHED_FIFO);
+    Sequencer sequencer{Sequencer::ReleaseMode::Dispatcher, bench.cpu};
+    std::vector<Service*> services;
+    for (size_t i = 0; i < bench.services.size(); ++i) {
+        auto kernel = bench.kernel;
+        auto wcet = std::chrono::nanoseconds(bench.services[i].wcet);
+        Service& service = sequencer.addService([&workload, kernel, wcet] { workload.run(kernel, wcet); },
+                                                static_cast<uint8_t>(bench.cpu),
+                                                static_cast<uint8_t>(maxPriority - 1 - static_cast<int>(i)),
+                                                std::chrono::nanoseconds(bench.services[i].period));
+        services.push_back(&service);
+    }
+
+    std::vector<std::unique_ptr<CoRunner>> coRunners;
+    for (auto kind : scenario.kinds) {
+        coRunners.push_back(std::make_unique<CoRunner>(kind, scenario.cpu, bench.coRunnerPriority));
+        coRunners.back()->start();
+    }
+
+    sequencer.startServices();
+    std::this_thread::sleep_for(bench.duration);
+    sequencer.stopServices(false);
+    for (auto& coRunner : coRunners) coRunner->stop();
+
+    Results results;
+    for (auto* service : services) {
+        auto result = std::make_unique<ServiceResult>();
+        result->jitter.merge(service->releaseJitterHistogram());
+        result->response.merge(service->responseTimeHistogram());
+        auto stats = service->statistics();
+        result->deadlineMisses = stats.deadlineMisses;
+        result->missedReleases = stats.missedReleases;
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+static std::vector<std::string> splitList(const char* text) {
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* p = text; ; ++p) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) items.push_back(item);
+            item.clear();
+            if (*p == '\0') break;
+        } else {
+            item += *p;
+        }
+    }
+    return items;
+}
+
+static void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-s period_ms:wcet_us,...] [-w alu|fp|stream|chase] [-r corunner,...] "
+                         "[-p same|sibling|cpu,...] [-n count] [-d seconds] [-a cpu] [-P priority]\nCo-runners:",
+                 prog);
+    for (auto kind : CoRunner::Kinds) std::fprintf(stderr, " %s", CoRunner::name(kind));
+    std::fprintf(stderr, "\n");
+}
+
+static double us(int64_t ns) {
+    return ns / 1000.0;
+}
+
+int main(int argc, char* argv[]) {
+    Bench bench;
+    std::vector<CoRunner::Kind> kinds(std::begin(CoRunner::Kinds), std::end(CoRunner::Kinds));
+    std::vector<std::string> placements = {"same"};
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:w:r:p:n:d:a:P:")) != -1) {
+        switch (opt) {
+        case 's':
+            for (const auto& spec : splitList(optarg)) {
+                long periodMs = 0, wcetUs = 0;
+                if (std::sscanf(spec.c_str(), "%ld:%ld", &periodMs, &wcetUs) != 2 || periodMs <= 0 || wcetUs <= 0) {
+                    usage(argv[0]);
+                    return 1;
+                }
+                bench.services.push_back({std::chrono::milliseconds(periodMs), std::chrono::microseconds(wcetUs)});
+            }
+            break;
+        case 'w':
+            if (!Workload::parse(optarg, bench.kernel)) { usage(argv[0]); return 1; }
+            break;
+        case 'r':
+            kinds.clear();
+            for (const auto& name : splitList(optarg)) {
+                CoRunner::Kind kind;
+                if (!CoRunner::parse(name, kind)) { usage(argv[0]); return 1; }
+                kinds.push_back(kind);
+            }
+            break;
+        case 'p': placements = splitList(optarg); break;
+        case 'n': bench.coRunners = std::max(1, std::atoi(optarg)); break;
+        case 'd': bench.duration = std::chrono::seconds(std::max(1, std::atoi(optarg))); break;
+        case 'a': bench.cpu = std::atoi(optarg); break;
+        case 'P': bench.coRunnerPriority = std::atoi(optarg); break;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (bench.services.empty()) {
+        using namespace std::chrono_literals;
+        bench.services = {{5ms, 1000us}, {10ms, 2000us}, {20ms, 4000us}};
+    }
+    // Rate-monotonic priorities
+    std::sort(bench.services.begin(), bench.services.end(),
+              [](const ServiceSpec& a, const ServiceSpec& b) { return a.period < b.period; });
+
+    std::vector<Scenario> scenarios = {{"baseline", {}, -1}};
+    for (const auto& placement : placements) {
+        int cpu;
+        if (placement == "same") {
+            cpu = bench.cpu;
+        } else if (placement == "sibling") {
+            cpu = CoRunner::siblingOf(bench.cpu);
+            if (cpu < 0) {
+                std::fprintf(stderr, "cpu %d has no SMT sibling: skipping sibling scenarios\n", bench.cpu);
+                continue;
+            }
+        } else {
+            cpu = std::atoi(placement.c_str());
+        }
+        for (auto kind : kinds) {
+            Scenario scenario{std::string(CoRunner::name(kind)) + "@" + placement, {}, cpu};
+            scenario.kinds.assign(static_cast<size_t>(bench.coRunners), kind);
+            scenarios.push_back(std::move(scenario));
+        }
+    }
+
+    // Calibrate the job bodies where the services will run
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(bench.cpu, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    RtClock::init();
+    Workload workload;
+    workload.calibrate();
+
+    double utilization = 0.0;
+    for (const auto& s : bench.services) {
+        utilization += std::chrono::duration<double>(s.wcet) / std::chrono::duration<double>(s.period);
+    }
+    std::printf("%zu services on cpu %d (%s, U=%.2f), %ld s per scenario, %d co-runner(s) at %s\n",
+                bench.services.size(), bench.cpu, Workload::name(bench.kernel), utilization,
+                static_cast<long>(bench.duration.count()), bench.coRunners,
+                bench.coRunnerPriority > 0 ? "SCHED_FIFO" : "SCHED_OTHER");
+
+    std::vector<Results> all;
+    for (const auto& scenario : scenarios) {
+        std::printf("\n%s", scenario.name.c_str());
+        if (scenario.cpu >= 0) std::printf(" (co-runner cpu %d)", scenario.cpu);
+        std::printf("\n");
+        std::fflush(stdout);
+        all.push_back(runScenario(bench, workload, scenario));
+
+        LatencyHistogram::printPercentileHeader();
+        for (size_t i = 0; i < bench.services.size(); ++i) {
+            std::string label = "svc" + std::to_string(i) + " (" + std::to_string(bench.services[i].period.count()) + " ms)";
+            all.back()[i]->jitter.printPercentileRow((label + " jitter").c_str());
+            all.back()[i]->response.printPercentileRow((label + " response").c_str());
+        }
+    }
+
+    std::printf("\nImpact vs baseline (us)\n");
+    std::printf("  %-22s %-5s %10s %10s %10s %10s %10s %7s %7s\n", "scenario", "svc",
+                "jit p99", "delta", "resp p99", "delta", "resp max", "misses", "skipped");
+    for (size_t s = 0; s < scenarios.size(); ++s) {
+        for (size_t i = 0; i < bench.services.size(); ++i) {
+            const auto& result = *all[s][i];
+            const auto& base = *all[0][i];
+            int64_t jitter = result.jitter.valueAtPercentile(99.0);
+            int64_t response = result.response.valueAtPercentile(99.0);
+            std::printf("  %-22s svc%-2zu %10.1f %+10.1f %10.1f %+10.1f %10.1f %7lu %7lu\n",
+                        scenarios[s].name.c_str(), i,
+                        us(jitter), us(jitter - base.jitter.valueAtPercentile(99.0)),
+                        us(response), us(response - base.response.valueAtPercentile(99.0)),
+                        us(result.response.max()), result.deadlineMisses, result.missedReleases);
+        }
+    }
+    return 0;
+}
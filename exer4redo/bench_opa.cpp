@@ -0,0 +1,147 @@
+/*
+ * Priority assignment at startup: Schedulability::assignPriorities()
+ * (Audsley's OPA, candidates in decreasing D - J, no copies) against the
+ * textbook Audsley loop, which tries the unplaced tasks in index order and
+ * builds the higher-priority set afresh for every try, and against one
+ * deadline-monotonic feasibility check as the floor.
+ *
+ * Task sets are UUniFast at utilization -u in random index order, with
+ * log-uniform periods from 1 ms to 1 s and D uniform in [C, m T]: with
+ * -m above 1 (arbitrary deadlines) deadline monotonic is no longer
+ * optimal, and OPA can accept sets it rejects. The textbook loop is O(n^2)
+ * analyses and is skipped above -n tasks.
+ *
+ * Build: make bench_opa
+ * Run:   ./bench_opa [-u utilization] [-m max_deadline_ratio] [-n max_textbook_tasks] [-t trials] [-s seed]
+ *                    [sizes...]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <unistd.h>
+#include "Schedulability.hpp"
+#include "TaskSetGenerator.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int64_t Ms = 1000000;
+
+static std::vector<TaskTiming> randomTaskSet(TaskSetGenerator& generator, double utilization, double maxDeadline) {
+    std::vector<TaskTiming> tasks;
+    for (double u : generator.uuniFast(utilization)) {
+        int64_t period = generator.logUniform(Ms, 1000 * Ms);
+        int64_t wcet = std::max<int64_t>(1, std::llround(u * static_cast<double>(period)));
+        int64_t deadline = std::max<int64_t>(wcet, std::llround(generator.uniform(0.0, maxDeadline) * period));
+        tasks.push_back(TaskTiming{wcet, period, deadline});
+    }
+    return tasks;
+}
+
+// Audsley as usually written: lowest level first, first fit in index order
+static bool textbookAudsley(const std::vector<TaskTiming>& tasks) {
+    std::vector<bool> placed(tasks.size(), false);
+    for (size_t level = tasks.size(); level-- > 0;) {
+        bool found = false;
+        for (size_t candidate = 0; candidate < tasks.size() && !found; ++candidate) {
+            if (placed[candidate]) continue;
+            std::vector<TaskTiming> set;
+            for (size_t other = 0; other < tasks.size(); ++other) {
+                if (!placed[other] && other != candidate) set.push_back(tasks[other]);
+            }
+            set.push_back(tasks[candidate]);
+            if (Schedulability::responseTime(set, set.size() - 1) != Schedulability::Unschedulable) {
+                placed[candidate] = found = true;
+            }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+static bool deadlineMonotonicFeasible(std::vector<TaskTiming> tasks) {
+    std::stable_sort(tasks.begin(), tasks.end(),
+                     [](const TaskTiming& a, const TaskTiming& b) { return a.deadline() < b.deadline(); });
+    return Schedulability::feasible(tasks);
+}
+
+template <typename F>
+static double secondsOf(F&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void printTime(double seconds) {
+    if (seconds < 1e-3) std::printf(" %10.2f us", seconds * 1e6);
+    else if (seconds < 1.0) std::printf(" %10.2f ms", seconds * 1e3);
+    else std::printf(" %10.2f s ", seconds);
+}
+
+int main(int argc, char* argv[]) {
+    double utilization = 0.9;
+    double maxDeadline = 2.0;
+    size_t maxTextbook = 300;
+    int trials = 20;
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "u:m:n:t:s:")) != -1) {
+        switch (opt) {
+        case 'u': utilization = std::atof(optarg); break;
+        case 'm': maxDeadline = std::max(0.01, std::atof(optarg)); break;
+        case 'n': maxTextbook = std::strtoul(optarg, nullptr, 10); break;
+        case 't': trials = std::max(1, std::atoi(optarg)); break;
+        case 's': seed = std::strtoull(optarg, nullptr, 10); break;
+        default:
+            std::fprintf(stderr,
+                         "Usage: %s [-u utilization] [-m max_deadline_ratio] [-n max_textbook_tasks] [-t trials] "
+                         "[-s seed] [sizes...]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    std::vector<size_t> sizes;
+    for (int i = optind; i < argc; ++i) sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {10, 50, 100, 300, 1000};
+
+    std::printf("U=%.2f, periods 1 ms..1 s, D in [C, %.2f T], mean of %d sets\n", utilization, maxDeadline, trials);
+    std::printf("%7s %13s %13s %13s %9s %9s %9s\n", "tasks", "dm check", "opa", "textbook", "speedup", "dm ok",
+                "opa ok");
+
+    for (size_t n : sizes) {
+        TaskSetGenerator generator(n, seed + n);
+        const bool textbook = n <= maxTextbook;
+        double dm = 0.0, opa = 0.0, naive = 0.0;
+        int dmFeasible = 0, opaFeasible = 0, agreed = 0;
+        std::vector<size_t> order;
+        for (int trial = 0; trial < trials; ++trial) {
+            auto tasks = randomTaskSet(generator, utilization, maxDeadline);
+            bool dmOk = false, opaOk = false, naiveOk = false;
+            dm += secondsOf([&] { dmOk = deadlineMonotonicFeasible(tasks); });
+            opa += secondsOf([&] { opaOk = Schedulability::assignPriorities(tasks, order); });
+            if (textbook) naive += secondsOf([&] { naiveOk = textbookAudsley(tasks); });
+            dmFeasible += dmOk;
+            opaFeasible += opaOk;
+            agreed += !textbook || naiveOk == opaOk;
+        }
+
+        std::printf("%7zu", n);
+        printTime(dm / trials);
+        printTime(opa / trials);
+        if (textbook) {
+            printTime(naive / trials);
+            std::printf(" %8.1fx", naive / std::max(opa, 1e-12));
+        } else {
+            std::printf(" %13s %9s", "-", "-");
+        }
+        std::printf(" %9d %9d", dmFeasible, opaFeasible);
+        if (agreed != trials) std::printf("  MISMATCH %d/%d", agreed, trials);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
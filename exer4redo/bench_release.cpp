@@ -0,0 +1,472 @@
+/*
+ * cyclictest-style comparison of the ways this repo releases periodic jobs.
+ * The same service set (one thread per period, rate-monotonic priorities)
+ * runs through each mechanism in turn; every job records its wakeup latency,
+ * i.e. when the service thread runs minus when it was supposed to:
+ *
+ *   sequencer-dispatcher  exer4redo Sequencer, clock_nanosleep dispatcher + futex release
+ *   sequencer-timer       exer4redo Sequencer, SIGEV_THREAD timer per service
+ *   sequencer-spin        exer4redo Sequencer, sleep-then-spin self release
+ *   sigalrm-tick          sk_exer4: SIGALRM master tick consumed by sigwaitinfo
+ *   pit-signal            exercise3 clock_pitsig: SIGEV_SIGNAL handler posting a sem_t
+ *   cv-wait-for           exercise5: condition_variable::wait_for(period)
+ *   sleep-until           exercise5 q7: std::this_thread::sleep_until(next)
+ *   nanosleep             exercise3 clock_nanosleep_test: relative nanosleep(period)
+ *   clock-nanosleep       clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)
+ *   timerfd               periodic timerfd, blocking read()
+ *
+ * Relative delays (cv-wait-for, nanosleep) are measured against the instant
+ * they were asked to wake at, so their drift is not counted as latency.
+ *
+ * Build: make bench_release
+ * Run:   ./bench_release [-m mech,...] [-p period_us,...] [-d seconds]
+ *                        [-P priority] [-a cpu] [-o latencies.csv] [-H histograms]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <semaphore.h>
+#include <signal.h>
+#include <string>
+#include <sys/timerfd.h>
+#include <thread>
+#include <vector>
+#include "Sequencer.hpp"
+
+using Clock = std::chrono::steady_clock;
+using Latencies = std::vector<std::unique_ptr<LatencyHistogram>>;
+
+struct Bench {
+    std::vector<std::chrono::nanoseconds> periods;
+    std::chrono::seconds duration{2};
+    int priority;
+    int cpu = 0;
+};
+
+static void setRealtime(int priority, int cpu) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+
+    struct sched_param param;
+    param.sched_priority = priority;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+}
+
+static timespec toTimespec(Clock::time_point tp) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+    return timespec{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+}
+
+static int64_t nsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+// Start a little in the future so every thread is waiting before the first release
+static Clock::time_point startEpoch() {
+    return RtClock::now() + std::chrono::milliseconds(20);
+}
+
+// One thread per service; wait(i, next) blocks and returns the instant the
+// thread asked to be woken at (next for absolute waits)
+template <typename Wait>
+static void runSelfPaced(const Bench& bench, Latencies& latencies, Wait wait) {
+    auto epoch = startEpoch();
+    auto end = epoch + bench.duration;
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < bench.periods.size(); ++i) {
+        threads.emplace_back([&, i] {
+            setRealtime(bench.priority - static_cast<int>(i), bench.cpu);
+            auto period = bench.periods[i];
+            for (auto next = epoch + period; next < end; next += period) {
+                Clock::time_point intended = wait(i, next);
+                latencies[i]->record(nsBetween(intended, RtClock::now()));
+                // After an overrun, skip the releases that are already gone
+                while (next + period < RtClock::now()) next += period;
+            }
+        });
+    }
+}
+
+static void runSequencer(const Bench& bench, Latencies& latencies, Sequencer::ReleaseMode mode, bool spin) {
+    Sequencer sequencer{mode, bench.cpu};
+    std::vector<Service*> services;
+    for (size_t i = 0; i < bench.periods.size(); ++i) {
+        Service& service = sequencer.addService([] {}, static_cast<uint8_t>(bench.cpu),
+                                                static_cast<uint8_t>(bench.priority - static_cast<int>(i)),
+                                                bench.periods[i]);
+        if (spin) service.enableSleepSpin();
+        services.push_back(&service);
+    }
+    sequencer.startServices();
+    std::this_thread::sleep_for(bench.duration);
+    sequencer.stopServices(false);
+    for (size_t i = 0; i < services.size(); ++i) {
+        latencies[i]->merge(services[i]->releaseJitterHistogram());
+    }
+}
+
+// Released mechanisms: a releaser posts per-service semaphores and stamps
+// the scheduled instant; the service thread measures against that stamp
+struct Released {
+    sem_t semaphore;
+    std::atomic<Clock::rep> scheduled{0};
+};
+
+static void runReleasedWorkers(const Bench& bench, Latencies& latencies, std::vector<Released>& released,
+                               std::atomic<bool>& stop, std::vector<std::jthread>& threads) {
+    for (size_t i = 0; i < bench.periods.size(); ++i) {
+        threads.emplace_back([&, i] {
+            setRealtime(bench.priority - static_cast<int>(i), bench.cpu);
+            while (true) {
+                while (sem_wait(&released[i].semaphore) != 0 && errno == EINTR) {}
+                auto now = RtClock::now();
+                if (stop) return;
+                auto scheduled = Clock::time_point(Clock::duration(released[i].scheduled.load()));
+                latencies[i]->record(nsBetween(scheduled, now));
+            }
+        });
+    }
+}
+
+static void runSigalrmTick(const Bench& bench, Latencies& latencies) {
+    std::vector<Released> released(bench.periods.size());
+    for (auto& r : released) sem_init(&r.semaphore, 0, 0);
+    std::atomic<bool> stop{false};
+
+    // Master tick at the gcd of the periods, like sk_exer4's masterIntervalMs
+    int64_t tickNs = 0;
+    for (auto period : bench.periods) tickNs = std::gcd(tickNs, period.count());
+    auto tick = std::chrono::nanoseconds(tickNs);
+
+    auto epoch = startEpoch();
+    auto end = epoch + bench.duration;
+    {
+        std::vector<std::jthread> threads;
+        runReleasedWorkers(bench, latencies, released, stop, threads);
+
+        timer_t timer;
+        struct sigevent sev;
+        std::memset(&sev, 0, sizeof(sev));
+        sev.sigev_notify = SIGEV_SIGNAL;
+        sev.sigev_signo = SIGALRM;
+        timer_create(CLOCK_MONOTONIC, &sev, &timer);
+
+        std::jthread dispatcher([&] {
+            setRealtime(sched_get_priority_max(SCHED_FIFO), bench.cpu);
+            sigset_t alarm;
+            sigemptyset(&alarm);
+            sigaddset(&alarm, SIGALRM);
+
+            struct itimerspec its;
+            its.it_value = toTimespec(epoch + tick);
+            its.it_interval = timespec{static_cast<time_t>(tickNs / 1000000000), static_cast<long>(tickNs % 1000000000)};
+            timer_settime(timer, TIMER_ABSTIME, &its, nullptr);
+
+            for (int64_t k = 1; epoch + k * tick < end; ++k) {
+                siginfo_t info;
+                while (sigwaitinfo(&alarm, &info) != SIGALRM) {}
+                k += std::max(timer_getoverrun(timer), 0);
+                auto instant = epoch + k * tick;
+                for (size_t i = 0; i < bench.periods.size(); ++i) {
+                    if ((k * tickNs) % bench.periods[i].count() != 0) continue;
+                    released[i].scheduled.store(instant.time_since_epoch().count());
+                    sem_post(&released[i].semaphore);
+                }
+            }
+            timer_delete(timer);
+        });
+        dispatcher.join();
+
+        stop = true;
+        for (auto& r : released) sem_post(&r.semaphore);
+    }
+    for (auto& r : released) sem_destroy(&r.semaphore);
+}
+
+// exercise3 style: one SIGEV_SIGNAL timer per service, the handler posts
+static std::vector<Released>* pitReleased = nullptr;
+
+static void pitHandler(int, siginfo_t* info, void*) {
+    sem_post(&(*pitReleased)[static_cast<size_t>(info->si_value.sival_int)].semaphore);
+}
+
+static void runPitSignal(const Bench& bench, Latencies& latencies) {
+    std::vector<Released> released(bench.periods.size());
+    for (auto& r : released) sem_init(&r.semaphore, 0, 0);
+    pitReleased = &released;
+    std::atomic<bool> stop{false};
+
+    struct sigaction sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sa_sigaction = pitHandler;
+    sa.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGRTMIN, &sa, nullptr);
+
+    auto epoch = startEpoch();
+    std::vector<timer_t> timers(bench.periods.size());
+    {
+        // Workers stamp the release themselves: the handler may only post
+        std::vector<std::jthread> threads;
+        for (size_t i = 0; i < bench.periods.size(); ++i) {
+            threads.emplace_back([&, i] {
+                setRealtime(bench.priority - static_cast<int>(i), bench.cpu);
+                auto period = bench.periods[i];
+                while (true) {
+                    while (sem_wait(&released[i].semaphore) != 0 && errno == EINTR) {}
+                    auto now = RtClock::now();
+                    if (stop) return;
+                    auto scheduled = epoch + ((now - epoch) / period) * period;
+                    latencies[i]->record(nsBetween(scheduled, now));
+                }
+            });
+        }
+
+        for (size_t i = 0; i < bench.periods.size(); ++i) {
+            struct sigevent sev;
+            std::memset(&sev, 0, sizeof(sev));
+            sev.sigev_notify = SIGEV_SIGNAL;
+            sev.sigev_signo = SIGRTMIN;
+            sev.sigev_value.sival_int = static_cast<int>(i);
+            timer_create(CLOCK_MONOTONIC, &sev, &timers[i]);
+
+            auto ns = bench.periods[i].count();
+            struct itimerspec its;
+            its.it_value = toTimespec(epoch + bench.periods[i]);
+            its.it_interval = timespec{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+            timer_settime(timers[i], TIMER_ABSTIME, &its, nullptr);
+        }
+
+        std::this_thread::sleep_until(epoch + bench.duration);
+        for (auto timer : timers) timer_delete(timer);
+        stop = true;
+        for (auto& r : released) sem_post(&r.semaphore);
+    }
+    signal(SIGRTMIN, SIG_DFL);
+    for (auto& r : released) sem_destroy(&r.semaphore);
+}
+
+static void runCvWaitFor(const Bench& bench, Latencies& latencies) {
+    std::vector<std::mutex> mutexes(bench.periods.size());
+    std::vector<std::condition_variable> cvs(bench.periods.size());
+    runSelfPaced(bench, latencies, [&](size_t i, Clock::time_point) {
+        std::unique_lock<std::mutex> lock(mutexes[i]);
+        auto intended = RtClock::now() + bench.periods[i];
+        cvs[i].wait_for(lock, bench.periods[i], [] { return false; });
+        return intended;
+    });
+}
+
+static void runSleepUntil(const Bench& bench, Latencies& latencies) {
+    runSelfPaced(bench, latencies, [](size_t, Clock::time_point next) {
+        std::this_thread::sleep_until(next);
+        return next;
+    });
+}
+
+static void runNanosleep(const Bench& bench, Latencies& latencies) {
+    runSelfPaced(bench, latencies, [&](size_t i, Clock::time_point) {
+        auto ns = bench.periods[i].count();
+        timespec delay{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        auto intended = RtClock::now() + bench.periods[i];
+        while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {}
+        return intended;
+    });
+}
+
+static void runClockNanosleep(const Bench& bench, Latencies& latencies) {
+    runSelfPaced(bench, latencies, [](size_t, Clock::time_point next) {
+        timespec wakeup = toTimespec(next);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR) {}
+        return next;
+    });
+}
+
+static void runTimerfd(const Bench& bench, Latencies& latencies) {
+    auto epoch = startEpoch();
+    auto end = epoch + bench.duration;
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < bench.periods.size(); ++i) {
+        threads.emplace_back([&, i] {
+            setRealtime(bench.priority - static_cast<int>(i), bench.cpu);
+            auto period = bench.periods[i];
+            int fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+            if (fd < 0) return;
+
+            auto ns = period.count();
+            struct itimerspec its;
+            its.it_value = toTimespec(epoch + period);
+            its.it_interval = timespec{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+            timerfd_settime(fd, TFD_TIMER_ABSTIME, &its, nullptr);
+
+            for (auto next = epoch + period; next < end; next += period) {
+                uint64_t expirations = 0;
+                if (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations)) break;
+                auto now = RtClock::now();
+                // More than one expiry: we missed some, measure the latest
+                next += (static_cast<int64_t>(expirations) - 1) * period;
+                latencies[i]->record(nsBetween(next, now));
+            }
+            close(fd);
+        });
+    }
+}
+
+struct Mechanism {
+    const char* name;
+    std::function<void(const Bench&, Latencies&)> run;
+};
+
+static std::vector<Mechanism> mechanisms() {
+    return {
+        {"sequencer-dispatcher", [](const Bench& b, Latencies& l) { runSequencer(b, l, Sequencer::ReleaseMode::Dispatcher, false); }},
+        {"sequencer-timer", [](const Bench& b, Latencies& l) { runSequencer(b, l, Sequencer::ReleaseMode::TimerThread, false); }},
+        {"sequencer-spin", [](const Bench& b, Latencies& l) { runSequencer(b, l, Sequencer::ReleaseMode::Dispatcher, true); }},
+        {"sigalrm-tick", runSigalrmTick},
+        {"pit-signal", runPitSignal},
+        {"cv-wait-for", runCvWaitFor},
+        {"sleep-until", runSleepUntil},
+        {"nanosleep", runNanosleep},
+        {"clock-nanosleep", runClockNanosleep},
+        {"timerfd", runTimerfd},
+    };
+}
+
+static std::vector<std::string> splitList(const char* text) {
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* p = text; ; ++p) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) items.push_back(item);
+            item.clear();
+            if (*p == '\0') break;
+        } else {
+            item += *p;
+        }
+    }
+    return items;
+}
+
+static void writeCsvRow(FILE* csv, const char* mechanism, const char* service, int64_t periodUs,
+                        const LatencyHistogram& h) {
+    std::fprintf(csv, "%s,%s,%ld,%lu,%ld", mechanism, service, periodUs, h.count(), h.min());
+    for (double p : LatencyHistogram::Percentiles) std::fprintf(csv, ",%ld", h.valueAtPercentile(p));
+    std::fprintf(csv, ",%ld,%.1f\n", h.max(), h.mean());
+}
+
+static void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-m mech,...] [-p period_us,...] [-d seconds] [-P priority] [-a cpu] "
+                         "[-o csv] [-H histogram_file]\nMechanisms:", prog);
+    for (const auto& m : mechanisms()) std::fprintf(stderr, " %s", m.name);
+    std::fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[]) {
+    // sigalrm-tick consumes SIGALRM with sigwaitinfo: block it before any thread starts
+    sigset_t alarm;
+    sigemptyset(&alarm);
+    sigaddset(&alarm, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &alarm, nullptr);
+
+    Bench bench;
+    bench.priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    std::vector<std::string> selected;
+    const char* csvPath = nullptr;
+    const char* histogramPath = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:p:d:P:a:o:H:")) != -1) {
+        switch (opt) {
+        case 'm': selected = splitList(optarg); break;
+        case 'p':
+            for (const auto& us : splitList(optarg)) {
+                if (std::atol(us.c_str()) <= 0) { usage(argv[0]); return 1; }
+                bench.periods.push_back(std::chrono::microseconds(std::atol(us.c_str())));
+            }
+            break;
+        case 'd': bench.duration = std::chrono::seconds(std::max(1, std::atoi(optarg))); break;
+        case 'P': bench.priority = std::atoi(optarg); break;
+        case 'a': bench.cpu = std::atoi(optarg); break;
+        case 'o': csvPath = optarg; break;
+        case 'H': histogramPath = optarg; break;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    if (bench.periods.empty()) {
+        bench.periods = {std::chrono::microseconds(1000), std::chrono::microseconds(2000), std::chrono::microseconds(5000)};
+    }
+    std::sort(bench.periods.begin(), bench.periods.end());   // rate-monotonic priorities
+    if (bench.priority - static_cast<int>(bench.periods.size()) + 1 < sched_get_priority_min(SCHED_FIFO)) {
+        std::fprintf(stderr, "priority %d too low for %zu services\n", bench.priority, bench.periods.size());
+        return 1;
+    }
+
+    std::vector<Mechanism> runs;
+    for (auto& m : mechanisms()) {
+        if (selected.empty() || std::find(selected.begin(), selected.end(), m.name) != selected.end()) {
+            runs.push_back(std::move(m));
+        }
+    }
+    if (runs.empty() || (!selected.empty() && runs.size() != selected.size())) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    FILE* csv = csvPath ? std::fopen(csvPath, "w") : nullptr;
+    if (csvPath && csv == nullptr) {
+        std::perror(csvPath);
+        return 1;
+    }
+    FILE* histograms = histogramPath ? std::fopen(histogramPath, "w") : nullptr;
+    if (histogramPath && histograms == nullptr) {
+        std::perror(histogramPath);
+        return 1;
+    }
+    if (csv) {
+        std::fprintf(csv, "mechanism,service,period_us,count,min_ns");
+        for (double p : LatencyHistogram::Percentiles) std::fprintf(csv, ",p%g_ns", p);
+        std::fprintf(csv, ",max_ns,mean_ns\n");
+    }
+
+    RtClock::init();
+    std::printf("Wakeup latency, %zu services (", bench.periods.size());
+    for (size_t i = 0; i < bench.periods.size(); ++i) {
+        std::printf("%s%ld us", i ? ", " : "", static_cast<long>(bench.periods[i].count() / 1000));
+    }
+    std::printf("), %ld s per mechanism, priority %d.., cpu %d\n",
+                static_cast<long>(bench.duration.count()), bench.priority, bench.cpu);
+    LatencyHistogram::printPercentileHeader();
+
+    for (const auto& mechanism : runs) {
+        Latencies latencies;
+        for (size_t i = 0; i < bench.periods.size(); ++i) latencies.push_back(std::make_unique<LatencyHistogram>());
+        mechanism.run(bench, latencies);
+
+        LatencyHistogram all;
+        for (size_t i = 0; i < latencies.size(); ++i) {
+            all.merge(*latencies[i]);
+            std::string service = "service" + std::to_string(i);
+            int64_t periodUs = bench.periods[i].count() / 1000;
+            if (csv) writeCsvRow(csv, mechanism.name, service.c_str(), periodUs, *latencies[i]);
+            if (histograms) latencies[i]->save(histograms, std::string(mechanism.name) + "." + service);
+        }
+        if (csv) writeCsvRow(csv, mechanism.name, "all", 0, all);
+        all.printPercentileRow(mechanism.name);
+        std::fflush(stdout);
+    }
+
+    if (csv) std::fclose(csv);
+    if (histograms) std::fclose(histograms);
+    return 0;
+}
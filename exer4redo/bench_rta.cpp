@@ -0,0 +1,165 @@
+/*
+ * Admission-decision latency of the incremental response-time analysis
+ * (IncrementalRta) against re-running the full analysis, for random
+ * rate-monotonic task sets of 10 to 10,000 tasks.
+ *
+ * Sets are generated with UUniFast at a total utilization of 0.6 and
+ * log-uniform periods between 1 ms and 1 s. For each size:
+ *   full       Schedulability::analyze of the whole set from scratch
+ *   admit      IncrementalRta::tryInsert of one more task at its RM
+ *              position (then removed again, untimed)
+ *   admit-cold the same decision by full re-analysis of the grown set
+ *   wcet+1%    IncrementalRta::trySetWcet growing one random task's WCET
+ * Decisions are checked against the full analysis, and for up to 1,000
+ * tasks so is every response time.
+ *
+ * Build: make bench_rta
+ * Run:   ./bench_rta [-u utilization] [-t trials] [-s seed] [sizes...]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include "Schedulability.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<TaskTiming> randomTaskSet(size_t n, double utilization, std::mt19937_64& random) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<TaskTiming> tasks;
+    double remaining = utilization;
+    for (size_t i = 0; i < n; ++i) {
+        // UUniFast (Bini & Buttazzo)
+        double share = remaining;
+        if (i + 1 < n) {
+            double next = remaining * std::pow(unit(random), 1.0 / static_cast<double>(n - i - 1));
+            share = remaining - next;
+            remaining = next;
+        }
+        auto period = static_cast<int64_t>(1e6 * std::pow(1000.0, unit(random)));   // 1 ms .. 1 s
+        tasks.push_back(TaskTiming{std::max<int64_t>(1, static_cast<int64_t>(share * period)), period});
+    }
+    std::sort(tasks.begin(), tasks.end(), [](const TaskTiming& a, const TaskTiming& b) { return a.periodNs < b.periodNs; });
+    return tasks;
+}
+
+static size_t rmPosition(const std::vector<TaskTiming>& tasks, const TaskTiming& task) {
+    auto it = std::upper_bound(tasks.begin(), tasks.end(), task,
+                               [](const TaskTiming& a, const TaskTiming& b) { return a.periodNs < b.periodNs; });
+    return static_cast<size_t>(it - tasks.begin());
+}
+
+template <typename F>
+static double secondsOf(F&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void printTime(double seconds) {
+    if (seconds < 1e-3) std::printf(" %10.2f us", seconds * 1e6);
+    else std::printf(" %10.2f ms", seconds * 1e3);
+}
+
+int main(int argc, char* argv[]) {
+    double utilization = 0.6;
+    int trials = 20;
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "u:t:s:")) != -1) {
+        switch (opt) {
+        case 'u': utilization = std::atof(optarg); break;
+        case 't': trials = std::max(1, std::atoi(optarg)); break;
+        case 's': seed = std::strtoull(optarg, nullptr, 10); break;
+        default:
+            std::fprintf(stderr, "Usage: %s [-u utilization] [-t trials] [-s seed] [sizes...]\n", argv[0]);
+            return 1;
+        }
+    }
+    std::vector<size_t> sizes;
+    for (int i = optind; i < argc; ++i) sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {10, 100, 1000, 10000};
+
+    std::mt19937_64 random(seed);
+    std::printf("RM task sets, U=%.2f, periods 1 ms..1 s, mean of %d decisions\n", utilization, trials);
+    std::printf("%7s %13s %13s %13s %13s %13s %8s\n", "tasks", "full", "admit", "admit max", "admit-cold",
+                "wcet+1%", "speedup");
+
+    for (size_t n : sizes) {
+        auto tasks = randomTaskSet(n, utilization, random);
+
+        bool feasible = false;
+        double full = secondsOf([&] { feasible = Schedulability::analyze(tasks).feasible; });
+
+        IncrementalRta rta;
+        for (const auto& task : tasks) rta.insert(rta.size(), task);
+        if (!feasible || !rta.feasible()) {
+            std::printf("%7zu  generated set not RM-feasible, skipped\n", n);
+            continue;
+        }
+        if (n <= 1000) {
+            auto reference = Schedulability::analyze(tasks);
+            for (size_t i = 0; i < n; ++i) {
+                if (rta.responseTime(i) != reference.responseNs[i]) {
+                    std::printf("%7zu  MISMATCH: task %zu response %ld, full analysis %ld\n",
+                                n, i, rta.responseTime(i), reference.responseNs[i]);
+                }
+            }
+        }
+
+        // Admission of one more small task, at its RM position
+        double admit = 0.0, admitMax = 0.0, admitCold = 0.0;
+        size_t admitted = 0, agreed = 0;
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        for (int trial = 0; trial < trials; ++trial) {
+            auto period = static_cast<int64_t>(1e6 * std::pow(1000.0, unit(random)));
+            TaskTiming extra{std::max<int64_t>(1, static_cast<int64_t>(period * 0.05 / static_cast<double>(n))), period};
+            size_t position = rmPosition(rta.tasks(), extra);
+
+            bool accepted = false;
+            double seconds = secondsOf([&] { accepted = rta.tryInsert(position, extra); });
+            admit += seconds;
+            admitMax = std::max(admitMax, seconds);
+
+            auto grown = tasks;
+            grown.insert(grown.begin() + static_cast<ptrdiff_t>(position), extra);
+            bool coldAccepted = false;
+            admitCold += secondsOf([&] { coldAccepted = Schedulability::analyze(grown).feasible; });
+
+            agreed += accepted == coldAccepted;
+            if (accepted) {
+                admitted++;
+                rta.erase(position);
+            }
+        }
+
+        // Growing one WCET by 1%, then restoring it
+        double wcet = 0.0;
+        std::uniform_int_distribution<size_t> pick(0, n - 1);
+        for (int trial = 0; trial < trials; ++trial) {
+            size_t i = pick(random);
+            int64_t previous = rta.task(i).wcetNs;
+            bool accepted = false;
+            wcet += secondsOf([&] { accepted = rta.trySetWcet(i, previous + previous / 100 + 1); });
+            if (accepted) rta.trySetWcet(i, previous);
+        }
+
+        std::printf("%7zu", n);
+        printTime(full);
+        printTime(admit / trials);
+        printTime(admitMax);
+        printTime(admitCold / trials);
+        printTime(wcet / trials);
+        std::printf(" %7.1fx", admitCold / std::max(admit, 1e-12));
+        if (agreed != static_cast<size_t>(trials)) std::printf("  MISMATCH %zu/%d", agreed, trials);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+/*
+ * Exact RM feasibility by scheduling points: the legacy C
+ * scheduling_point_feasibility() from exercise2/FeasibilityExampleCode,
+ * which tries every l*T_k <= T_i for every k <= i, against
+ * Schedulability::schedulingPointFeasible() over the reduced point set,
+ * and against response-time analysis.
+ *
+ * Task sets are UUniFast at utilization -u with log-uniform periods over
+ * a ratio of -r (shortest 100 us), in integer us so they fit the legacy
+ * U32_T arrays. Wide ratios are where the legacy test takes seconds: its
+ * point count grows with T_i / T_k, the reduced set with the number of
+ * distinct floor(t / T_j) T_j steps only (and of those, only the ones
+ * above a lower bound on the response time are generated).
+ *
+ * Build: make bench_schedpoint
+ * Run:   ./bench_schedpoint [-u utilization] [-r period_ratio] [-t trials] [-s seed] [sizes...]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <unistd.h>
+#include "Schedulability.hpp"
+
+extern "C" int scheduling_point_feasibility(unsigned numServices, unsigned period[], unsigned wcet[],
+                                            unsigned deadline[]);
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr int64_t MinPeriodUs = 100;
+
+static std::vector<TaskTiming> randomTaskSet(size_t n, double utilization, double ratio, std::mt19937_64& random) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<TaskTiming> tasks;
+    double remaining = utilization;
+    for (size_t i = 0; i < n; ++i) {
+        // UUniFast (Bini & Buttazzo)
+        double share = remaining;
+        if (i + 1 < n) {
+            double next = remaining * std::pow(unit(random), 1.0 / static_cast<double>(n - i - 1));
+            share = remaining - next;
+            remaining = next;
+        }
+        auto period = static_cast<int64_t>(MinPeriodUs * std::pow(ratio, unit(random)));
+        tasks.push_back(TaskTiming{std::max<int64_t>(1, static_cast<int64_t>(share * period)), period});
+    }
+    std::sort(tasks.begin(), tasks.end(), [](const TaskTiming& a, const TaskTiming& b) { return a.periodNs < b.periodNs; });
+    return tasks;
+}
+
+// Points the legacy test can visit: sum over i, k <= i of floor(T_i / T_k)
+static uint64_t legacyPoints(const std::vector<TaskTiming>& tasks) {
+    uint64_t count = 0;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        for (size_t k = 0; k <= i; ++k) count += static_cast<uint64_t>(tasks[i].periodNs / tasks[k].periodNs);
+    }
+    return count;
+}
+
+static uint64_t reducedPoints(const std::vector<TaskTiming>& tasks) {
+    uint64_t count = 0;
+    std::vector<double> points;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        Schedulability::schedulingPoints(tasks, i, points);
+        count += points.size();
+    }
+    return count;
+}
+
+template <typename F>
+static double secondsOf(F&& f) {
+    auto start = Clock::now();
+    f();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static void printTime(double seconds) {
+    if (seconds < 1e-3) std::printf(" %10.2f us", seconds * 1e6);
+    else if (seconds < 1.0) std::printf(" %10.2f ms", seconds * 1e3);
+    else std::printf(" %10.2f s ", seconds);
+}
+
+int main(int argc, char* argv[]) {
+    double utilization = 0.85;
+    double ratio = 10000.0;
+    int trials = 5;
+    uint64_t seed = 1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "u:r:t:s:")) != -1) {
+        switch (opt) {
+        case 'u': utilization = std::atof(optarg); break;
+        case 'r': ratio = std::max(1.0, std::atof(optarg)); break;
+        case 't': trials = std::max(1, std::atoi(optarg)); break;
+        case 's': seed = std::strtoull(optarg, nullptr, 10); break;
+        default:
+            std::fprintf(stderr, "Usage: %s [-u utilization] [-r period_ratio] [-t trials] [-s seed] [sizes...]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    std::vector<size_t> sizes;
+    for (int i = optind; i < argc; ++i) sizes.push_back(std::strtoul(argv[i], nullptr, 10));
+    if (sizes.empty()) sizes = {5, 10, 20, 50};
+
+    std::mt19937_64 random(seed);
+    std::printf("RM task sets, U=%.2f, periods %ld us..%.0f us, mean of %d sets\n", utilization, MinPeriodUs,
+                MinPeriodUs * ratio, trials);
+    std::printf("%7s %13s %13s %13s %13s %13s %9s\n", "tasks", "legacy", "reduced", "rta", "legacy pts",
+                "reduced pts", "speedup");
+
+    for (size_t n : sizes) {
+        double legacy = 0.0, reduced = 0.0, rta = 0.0;
+        uint64_t legacyCount = 0, reducedCount = 0;
+        int feasible = 0, agreed = 0;
+        for (int trial = 0; trial < trials; ++trial) {
+            auto tasks = randomTaskSet(n, utilization, ratio, random);
+            std::vector<unsigned> period, wcet;
+            for (const auto& task : tasks) {
+                period.push_back(static_cast<unsigned>(task.periodNs));
+                wcet.push_back(static_cast<unsigned>(task.wcetNs));
+            }
+
+            bool legacyFeasible = false, reducedFeasible = false, rtaFeasible = false;
+            legacy += secondsOf([&] {
+                legacyFeasible = scheduling_point_feasibility(static_cast<unsigned>(n), period.data(), wcet.data(),
+                                                              period.data()) != 0;
+            });
+            reduced += secondsOf([&] { reducedFeasible = Schedulability::schedulingPointFeasible(tasks); });
+            rta += secondsOf([&] { rtaFeasible = Schedulability::analyze(tasks).feasible; });
+            legacyCount += legacyPoints(tasks);
+            reducedCount += reducedPoints(tasks);
+
+            feasible += rtaFeasible;
+            agreed += legacyFeasible == rtaFeasible && reducedFeasible == rtaFeasible;
+        }
+
+        std::printf("%7zu", n);
+        printTime(legacy / trials);
+        printTime(reduced / trials);
+        printTime(rta / trials);
+        std::printf(" %13lu %13lu %8.1fx  %d/%d feasible", legacyCount / trials, reducedCount / trials,
+                    legacy / std::max(reduced, 1e-12), feasible, trials);
+        if (agreed != trials) std::printf("  MISMATCH %d/%d", agreed, trials);
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+    return 0;
+}
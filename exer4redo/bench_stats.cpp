@@ -0,0 +1,165 @@
+/*
+ * Cost of publishing Service statistics while another thread reads them:
+ *   mutex   - previous scheme: the job locks around every update and
+ *             printStatistics() holds the same lock while formatting
+ *   seqlock - current scheme: the job publishes through SeqLock, readers
+ *             copy a snapshot and format it without holding anything
+ * Then a live 1 kHz Service with a reader hammering statistics().
+ *
+ * Build: make bench_stats
+ * Run:   ./bench_stats [seconds]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include "Sequencer.hpp"
+
+using Statistics = Service::Statistics;
+
+struct PublishResult {
+    double avgNs;
+    double maxNs;
+    uint64_t reads;
+};
+
+// What printStatistics() does with a snapshot, roughly
+static size_t format(const Statistics& stats) {
+    char line[256];
+    int n = std::snprintf(line, sizeof(line), "%lu %.3f %.3f %.3f %lu %.3f",
+                          stats.executionCount, stats.minExecutionTime, stats.maxExecutionTime,
+                          stats.totalExecutionTime / std::max<uint64_t>(stats.executionCount, 1),
+                          stats.deadlineMisses, stats.maxLateness);
+    return static_cast<size_t>(n);
+}
+
+// The job side: update a few fields the way _provideService does, publish,
+// then pause so readers get the CPU between jobs
+template <typename Publish>
+static PublishResult runWriter(uint64_t jobs, Publish publish, std::atomic<bool>& done,
+                               std::atomic<uint64_t>& reads) {
+    Statistics stats;
+    double totalNs = 0, maxNs = 0;
+    for (uint64_t i = 0; i < jobs; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        publish(stats, i);
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        totalNs += ns;
+        maxNs = std::max(maxNs, ns);
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+    done = true;
+    return {totalNs / jobs, maxNs, reads.load()};
+}
+
+static void update(Statistics& stats, uint64_t i) {
+    double t = 0.1 + (i % 7) * 0.01;
+    stats.minExecutionTime = std::min(stats.minExecutionTime, t);
+    stats.maxExecutionTime = std::max(stats.maxExecutionTime, t);
+    stats.totalExecutionTime += t;
+    stats.executionCount++;
+}
+
+static PublishResult benchMutex(uint64_t jobs) {
+    std::mutex mutex;
+    Statistics shared;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    size_t sink = 0;
+
+    std::jthread reader([&] {
+        while (!done) {
+            std::lock_guard<std::mutex> lock(mutex);
+            sink += format(shared);
+            reads++;
+        }
+    });
+    auto result = runWriter(jobs, [&](Statistics& stats, uint64_t i) {
+        std::lock_guard<std::mutex> lock(mutex);
+        update(stats, i);
+        shared = stats;
+    }, done, reads);
+    reader.join();
+    if (sink == 1) std::printf(" ");
+    return result;
+}
+
+static PublishResult benchSeqLock(uint64_t jobs) {
+    SeqLock<Statistics> published;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    size_t sink = 0;
+
+    std::jthread reader([&] {
+        while (!done) {
+            sink += format(published.load());
+            reads++;
+        }
+    });
+    auto result = runWriter(jobs, [&](Statistics& stats, uint64_t i) {
+        update(stats, i);
+        published.store(stats);
+    }, done, reads);
+    reader.join();
+    if (sink == 1) std::printf(" ");
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int seconds = 3;
+    if (argc > 1) {
+        seconds = std::atoi(argv[1]);
+        if (seconds <= 0) {
+            std::fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    constexpr uint64_t Jobs = 20000;
+    std::printf("Statistics: %zu bytes\n", sizeof(Statistics));
+    std::printf("Publish per job with a concurrent reader (%lu jobs):\n", Jobs);
+    std::printf("  %-8s %10s %10s %12s\n", "scheme", "avg ns", "max ns", "reads");
+    for (auto [name, bench] : {std::pair{"mutex", &benchMutex}, std::pair{"seqlock", &benchSeqLock}}) {
+        PublishResult r = bench(Jobs);
+        std::printf("  %-8s %10.1f %10.1f %12lu\n", name, r.avgNs, r.maxNs, r.reads);
+    }
+
+    // Live service: released at 1 kHz from this thread while a reader
+    // takes snapshots as fast as it can
+    std::atomic<uint64_t> work{0};
+    Service service([&] { work.fetch_add(1, std::memory_order_relaxed); }, 0, 1, 1);
+    auto epoch = std::chrono::steady_clock::now();
+    service.setReleaseEpoch(epoch);
+
+    std::atomic<bool> done{false};
+    uint64_t snapshots = 0, lastCount = 0, regressions = 0;
+    std::jthread reader([&] {
+        while (!done) {
+            Statistics stats = service.statistics();
+            if (stats.executionCount < lastCount) regressions++;
+            lastCount = stats.executionCount;
+            snapshots++;
+        }
+    });
+
+    auto release = epoch;
+    auto end = epoch + std::chrono::seconds(seconds);
+    while ((release += service.getPeriod()) < end) {
+        std::this_thread::sleep_until(release);
+        service.release(release);
+    }
+    done = true;
+    reader.join();
+    service.stop();
+
+    Statistics stats = service.statistics();
+    std::printf("Live 1 kHz service for %d s:\n", seconds);
+    std::printf("  jobs %lu, snapshots %lu (%.0f/s), count went backwards %lu times\n",
+                stats.executionCount, snapshots, static_cast<double>(snapshots) / seconds, regressions);
+    return regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+/*
+ * Inter-thread wake latency of the primitives a releaser can use to start a
+ * blocked thread, the same ones used around the repo:
+ *
+ *   futex             FutexRelease (the Service release signal)
+ *   counting-sem      std::counting_semaphore<1> (sk_exer4, exercise5)
+ *   sem_t             POSIX unnamed semaphore (Q2_MUTEX, incdecthread)
+ *   named-sem         sem_open() semaphore (hw2)
+ *   condvar           std::mutex + std::condition_variable + counter (exercise5)
+ *   eventfd           eventfd write / blocking read
+ *   pipe              one-byte write / blocking read
+ *   rt-signal         pthread_sigqueue(SIGRTMIN) with payload / sigwaitinfo
+ *                     (signal_demo.c, posix_linux_demo.c)
+ *
+ * A waker thread sleeps an interval, stamps the clock and posts; the waiter,
+ * parked on the primitive, records when it runs again. Rows per primitive:
+ *   wake  one-way, post stamp to waiter running
+ *   post  cost of the post call on the waker (waiter parked, so it includes
+ *         the wakeup syscall; on the same core under SCHED_FIFO it also
+ *         includes the waiter's run, which preempts the waker)
+ *   rtt   ping-pong round trip: waker posts, waiter posts back
+ *
+ * Every primitive runs in each placement: waker and waiter on the same core
+ * and on two cores, with the cores idle and loaded by a cache-polluting
+ * SCHED_OTHER spinner per core. Cross-core runs are skipped on one CPU.
+ *
+ * Build: make bench_wake
+ * Run:   ./bench_wake [-m prim,...] [-n wakeups] [-i interval_us] [-P priority]
+ *                     [-a waker_cpu] [-b waiter_cpu]
+ *        The waiter runs SCHED_FIFO at the priority (default max - 1) and the
+ *        waker one below it; -P 0 keeps both threads SCHED_OTHER.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <semaphore.h>
+#include <signal.h>
+#include <string>
+#include <sys/eventfd.h>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "FutexRelease.hpp"
+#include "LatencyHistogram.hpp"
+#include "RtClock.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+struct Bench {
+    uint64_t wakeups = 5000;
+    std::chrono::microseconds interval{200};
+    int priority;
+};
+
+struct Placement {
+    const char* name;
+    int wakerCpu;
+    int waiterCpu;
+    bool loaded;
+};
+
+struct Result {
+    LatencyHistogram wake;
+    LatencyHistogram post;
+    LatencyHistogram roundTrip;
+};
+
+// Primitives: attach() runs on the thread that will wait, before any post
+
+struct FutexWake {
+    FutexRelease release;
+    void attach() {}
+    void post() { release.release(); }
+    void wait() { release.wait(); }
+};
+
+struct CountingSemWake {
+    std::counting_semaphore<1> semaphore{0};
+    void attach() {}
+    void post() { semaphore.release(); }
+    void wait() { semaphore.acquire(); }
+};
+
+struct PosixSemWake {
+    sem_t semaphore;
+    PosixSemWake() { sem_init(&semaphore, 0, 0); }
+    ~PosixSemWake() { sem_destroy(&semaphore); }
+    void attach() {}
+    void post() { sem_post(&semaphore); }
+    void wait() { while (sem_wait(&semaphore) != 0) {} }
+};
+
+struct NamedSemWake {
+    sem_t* semaphore;
+    NamedSemWake() {
+        static std::atomic<int> instance{0};
+        std::string name = "/bench_wake." + std::to_string(getpid()) + "." + std::to_string(instance++);
+        semaphore = sem_open(name.c_str(), O_CREAT | O_EXCL, 0600, 0);
+        if (semaphore == SEM_FAILED) {
+            std::perror("sem_open");
+            std::exit(1);
+        }
+        sem_unlink(name.c_str());   // the open handle keeps it alive
+    }
+    ~NamedSemWake() { sem_close(semaphore); }
+    void attach() {}
+    void post() { sem_post(semaphore); }
+    void wait() { while (sem_wait(semaphore) != 0) {} }
+};
+
+struct CondVarWake {
+    std::mutex mutex;
+    std::condition_variable cv;
+    uint64_t pending = 0;
+    void attach() {}
+    void post() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending++;
+        }
+        cv.notify_one();
+    }
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return pending > 0; });
+        pending--;
+    }
+};
+
+struct EventFdWake {
+    int fd = eventfd(0, EFD_CLOEXEC);
+    ~EventFdWake() { close(fd); }
+    void attach() {}
+    void post() {
+        uint64_t one = 1;
+        ssize_t n = write(fd, &one, sizeof(one));
+        (void)n;
+    }
+    void wait() {
+        uint64_t count;
+        while (read(fd, &count, sizeof(count)) != sizeof(count)) {}
+    }
+};
+
+struct PipeWake {
+    int fds[2];
+    PipeWake() {
+        if (pipe2(fds, O_CLOEXEC) != 0) {
+            std::perror("pipe2");
+            std::exit(1);
+        }
+    }
+    ~PipeWake() {
+        close(fds[0]);
+        close(fds[1]);
+    }
+    void attach() {}
+    void post() {
+        char byte = 1;
+        ssize_t n = write(fds[1], &byte, 1);
+        (void)n;
+    }
+    void wait() {
+        char byte;
+        while (read(fds[0], &byte, 1) != 1) {}
+    }
+};
+
+// SIGRTMIN is blocked in every thread (main blocks it before starting any),
+// so a queued signal stays pending until the target's sigwaitinfo
+struct RtSignalWake {
+    pthread_t target{};
+    sigset_t set;
+    int payload = 0;
+    RtSignalWake() {
+        sigemptyset(&set);
+        sigaddset(&set, SIGRTMIN);
+    }
+    void attach() { target = pthread_self(); }
+    void post() { pthread_sigqueue(target, SIGRTMIN, sigval{.sival_int = payload++}); }
+    void wait() {
+        siginfo_t info;
+        while (sigwaitinfo(&set, &info) != SIGRTMIN) {}
+    }
+};
+
+static bool setThread(int policy, int priority, int cpu) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+
+    struct sched_param param;
+    param.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), policy, &param) == 0;
+}
+
+static int64_t nsBetween(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+// One SCHED_OTHER spinner per loaded core, walking a buffer larger than a
+// typical L2 so the measured threads also find their cache lines evicted
+class Load {
+public:
+    explicit Load(std::vector<int> cpus) {
+        for (int cpu : cpus) {
+            _threads.emplace_back([cpu](std::stop_token stop) {
+                setThread(SCHED_OTHER, 0, cpu);
+                std::vector<uint64_t> buffer(1 << 20);
+                uint64_t sum = 0;
+                while (!stop.stop_requested()) {
+                    for (size_t i = 0; i < buffer.size(); i += 8) sum += buffer[i]++;
+                }
+                volatile uint64_t sink = sum;
+                (void)sink;
+            });
+        }
+    }
+
+private:
+    std::vector<std::jthread> _threads;
+};
+
+template <typename Primitive>
+static void measure(const Bench& bench, const Placement& placement, Result& result) {
+    Primitive ping, pong;
+    std::atomic<int64_t> postedAt{0};
+    std::atomic<uint64_t> woken{0};
+    std::atomic<bool> attached{false};
+    int policy = bench.priority > 0 ? SCHED_FIFO : SCHED_OTHER;
+
+    std::jthread waiter([&] {
+        setThread(policy, bench.priority, placement.waiterCpu);
+        ping.attach();
+        attached.store(true, std::memory_order_release);
+
+        for (uint64_t i = 0; i < bench.wakeups; ++i) {
+            ping.wait();
+            auto now = RtClock::now();
+            result.wake.record(now.time_since_epoch().count() - postedAt.load(std::memory_order_acquire));
+            woken.store(i + 1, std::memory_order_release);
+        }
+        for (uint64_t i = 0; i < bench.wakeups; ++i) {
+            ping.wait();
+            pong.post();
+        }
+    });
+
+    setThread(policy, bench.priority > 0 ? bench.priority - 1 : 0, placement.wakerCpu);
+    pong.attach();
+    while (!attached.load(std::memory_order_acquire)) std::this_thread::yield();
+
+    // One-way
+    auto next = RtClock::now() + std::chrono::milliseconds(10);
+    for (uint64_t i = 0; i < bench.wakeups; ++i) {
+        std::this_thread::sleep_until(next);
+        next += bench.interval;
+
+        auto stamp = RtClock::now();
+        postedAt.store(stamp.time_since_epoch().count(), std::memory_order_release);
+        ping.post();
+        result.post.record(nsBetween(stamp, RtClock::now()));
+
+        // The waiter must be parked again before the next post
+        while (woken.load(std::memory_order_acquire) != i + 1) std::this_thread::yield();
+    }
+
+    // Ping-pong
+    next = RtClock::now() + bench.interval;
+    for (uint64_t i = 0; i < bench.wakeups; ++i) {
+        std::this_thread::sleep_until(next);
+        next += bench.interval;
+
+        auto stamp = RtClock::now();
+        ping.post();
+        pong.wait();
+        result.roundTrip.record(nsBetween(stamp, RtClock::now()));
+    }
+
+    waiter.join();
+    setThread(SCHED_OTHER, 0, placement.wakerCpu);
+}
+
+struct Primitive {
+    const char* name;
+    void (*run)(const Bench&, const Placement&, Result&);
+};
+
+static const Primitive primitives[] = {
+    {"futex", measure<FutexWake>},
+    {"counting-sem", measure<CountingSemWake>},
+    {"sem_t", measure<PosixSemWake>},
+    {"named-sem", measure<NamedSemWake>},
+    {"condvar", measure<CondVarWake>},
+    {"eventfd", measure<EventFdWake>},
+    {"pipe", measure<PipeWake>},
+    {"rt-signal", measure<RtSignalWake>},
+};
+
+static std::vector<std::string> splitList(const char* arg) {
+    std::vector<std::string> items;
+    std::string item;
+    for (const char* p = arg;; ++p) {
+        if (*p == ',' || *p == '\0') {
+            if (!item.empty()) items.push_back(item);
+            item.clear();
+            if (*p == '\0') break;
+        } else {
+            item += *p;
+        }
+    }
+    return items;
+}
+
+static void usage(const char* prog) {
+    std::fprintf(stderr, "Usage: %s [-m prim,...] [-n wakeups] [-i interval_us] [-P priority] "
+                         "[-a waker_cpu] [-b waiter_cpu]\nPrimitives:", prog);
+    for (const auto& p : primitives) std::fprintf(stderr, " %s", p.name);
+    std::fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[]) {
+    // rt-signal: SIGRTMIN must be blocked in every thread before any starts
+    sigset_t rtSignal;
+    sigemptyset(&rtSignal);
+    sigaddset(&rtSignal, SIGRTMIN);
+    pthread_sigmask(SIG_BLOCK, &rtSignal, nullptr);
+
+    Bench bench;
+    bench.priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    std::vector<std::string> selected;
+    int cpus = static_cast<int>(std::thread::hardware_concurrency());
+    int wakerCpu = 0;
+    int waiterCpu = -1;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "m:n:i:P:a:b:")) != -1) {
+        switch (opt) {
+        case 'm': selected = splitList(optarg); break;
+        case 'n': bench.wakeups = std::max(1L, std::atol(optarg)); break;
+        case 'i': bench.interval = std::chrono::microseconds(std::max(1L, std::atol(optarg))); break;
+        case 'P': bench.priority = std::atoi(optarg); break;
+        case 'a': wakerCpu = std::atoi(optarg); break;
+        case 'b': waiterCpu = std::atoi(optarg); break;
+        default: usage(argv[0]); return 1;
+        }
+    }
+    for (const auto& name : selected) {
+        if (std::none_of(std::begin(primitives), std::end(primitives),
+                         [&](const Primitive& p) { return name == p.name; })) {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (waiterCpu < 0) waiterCpu = (wakerCpu + 1) % std::max(cpus, 1);
+
+    if (bench.priority > 0 && !setThread(SCHED_FIFO, bench.priority, wakerCpu)) {
+        std::fprintf(stderr, "SCHED_FIFO not permitted, running SCHED_OTHER\n");
+        bench.priority = 0;
+    }
+    setThread(SCHED_OTHER, 0, wakerCpu);
+
+    std::vector<Placement> placements = {
+        {"same core, idle", wakerCpu, wakerCpu, false},
+        {"same core, loaded", wakerCpu, wakerCpu, true},
+    };
+    if (waiterCpu != wakerCpu) {
+        placements.push_back({"cross core, idle", wakerCpu, waiterCpu, false});
+        placements.push_back({"cross core, loaded", wakerCpu, waiterCpu, true});
+    } else {
+        std::fprintf(stderr, "one CPU: skipping cross-core runs\n");
+    }
+
+    RtClock::init();
+    std::printf("Wake latency, %lu wakeups every %ld us, %s\n",
+                bench.wakeups, static_cast<long>(bench.interval.count()),
+                bench.priority > 0 ? "SCHED_FIFO" : "SCHED_OTHER");
+
+    for (const auto& placement : placements) {
+        std::printf("\n%s (waker cpu %d, waiter cpu %d)\n", placement.name, placement.wakerCpu, placement.waiterCpu);
+        LatencyHistogram::printPercentileHeader();
+
+        std::vector<int> loadCpus;
+        if (placement.loaded) {
+            loadCpus.push_back(placement.wakerCpu);
+            if (placement.waiterCpu != placement.wakerCpu) loadCpus.push_back(placement.waiterCpu);
+        }
+        Load load(loadCpus);
+
+        for (const auto& primitive : primitives) {
+            if (!selected.empty() && std::find(selected.begin(), selected.end(), primitive.name) == selected.end()) {
+                continue;
+            }
+            auto result = std::make_unique<Result>();
+            primitive.run(bench, placement, *result);
+            std::string name = primitive.name;
+            result->wake.printPercentileRow((name + " wake").c_str());
+            result->post.printPercentileRow((name + " post").c_str());
+            result->roundTrip.printPercentileRow((name + " rtt").c_str());
+            std::fflush(stdout);
+        }
+    }
+    return 0;
+}
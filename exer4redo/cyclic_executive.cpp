@@ -0,0 +1,104 @@
+/*
+ * Linux port of the lab1 VxWorks LCM schedule (Fib10 every 20 ms, Fib20
+ * every 50 ms, 100 ms hyperperiod) using a compile-time release table
+ * instead of a chain of taskDelay()/semGive() calls. The Fib10/Fib20 job
+ * bodies are calibrated Workload runs of 10 ms and 20 ms, so no iteration
+ * count needs tuning per board.
+ *
+ * Build with g++ --std=c++23 -Wall -Werror -pedantic
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <sys/syslog.h>
+#include <sched.h>
+#include "Sequencer.hpp"
+#include "CyclicExecutive.hpp"
+#include "Workload.hpp"
+
+// Fib10 = service 0, Fib20 = service 1; hyperperiods above 1 s are refused
+using Lab1Schedule = CyclicSchedule<1'000'000,
+                                    Periodic<20'000>,
+                                    Periodic<50'000>>;
+
+static_assert(Lab1Schedule::Hyperperiod == 100'000);
+static_assert(Lab1Schedule::NumFrames == 6);
+
+// Calibrated job bodies: a fixed amount of work per job, no clock reads
+Workload workload;
+Workload::Kernel loadKernel = Workload::Kernel::IntegerAlu;
+
+void fib10() { workload.run(loadKernel, std::chrono::milliseconds(10)); }
+void fib20() { workload.run(loadKernel, std::chrono::milliseconds(20)); }
+
+int main(int argc, char* argv[]) {
+    int runtime_seconds = 5;
+    if (argc > 1) {
+        runtime_seconds = std::atoi(argv[1]);
+        if (runtime_seconds <= 0) {
+            std::fprintf(stderr, "Invalid runtime. Using default 5 seconds.\n");
+            runtime_seconds = 5;
+        }
+    }
+    if (argc > 2 && !Workload::parse(argv[2], loadKernel)) {
+        std::fprintf(stderr, "Unknown kernel %s (alu, fp, stream, chase)\n", argv[2]);
+        return 1;
+    }
+
+    openlog("rt_cyclic", LOG_PID | LOG_CONS, LOG_USER);
+
+    int maxPriority = sched_get_priority_max(SCHED_FIFO);
+
+    // Calibrate on the services' core, then restore main's affinity
+    cpu_set_t mainCpus;
+    pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &mainCpus);
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(0, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    RtClock::init();
+    workload.calibrate();
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &mainCpus);
+    std::printf("Job bodies: %s kernel, 10 ms and 20 ms\n", Workload::name(loadKernel));
+
+    std::printf("Cyclic executive: %zu frames per %lu us hyperperiod\n",
+                Lab1Schedule::NumFrames, Lab1Schedule::Hyperperiod);
+    for (const auto& frame : Lab1Schedule::Table) {
+        std::printf("  +%3lu ms:%s%s\n", frame.offsetUs / 1000,
+                    (frame.releaseMask & 1) ? " Fib10" : "",
+                    (frame.releaseMask & 2) ? " Fib20" : "");
+    }
+
+    // Rate monotonic priorities below the executive, all on core 0
+    Service fib10Service(fib10, 0, maxPriority - 1, 20);
+    Service fib20Service(fib20, 0, maxPriority - 2, 50);
+    Service* services[] = {&fib10Service, &fib20Service};
+
+    auto release = [&services](size_t index, std::chrono::steady_clock::time_point scheduled) {
+        services[index]->release(scheduled);
+    };
+    CyclicExecutive<Lab1Schedule, decltype(release)> executive(release, 0);
+
+    auto epoch = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+    for (auto* service : services) {
+        service->setReleaseEpoch(epoch);
+    }
+    executive.start(epoch);
+
+    std::this_thread::sleep_for(std::chrono::seconds(runtime_seconds));
+
+    executive.stop();
+    for (auto* service : services) {
+        service->stop();
+    }
+
+    std::printf("\nFrames dispatched: %lu\n", executive.framesDispatched());
+    for (auto* service : services) {
+        service->printStatistics();
+    }
+
+    closelog();
+    return 0;
+}
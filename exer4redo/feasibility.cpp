@@ -0,0 +1,78 @@
+/*
+ * The ex0..ex4 service sets of exercise2/FeasibilityExampleCode/
+ * feasibility_tests.c run through Schedulability.hpp, plus variants with
+ * the terms the C code cannot express (D < T, release jitter, blocking),
+ * the EDF verdict it does not implement, and whether Audsley's optimal
+ * priority assignment finds an order that works where the listed (rate
+ * or deadline monotonic) one does not. The last set is harmonic at
+ * exactly U = 1, where every exact test must accept.
+ * Times are in ms as in the C examples.
+ *
+ * Build: make feasibility
+ * Run:   ./feasibility
+ */
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "EdfSchedulability.hpp"
+#include "Schedulability.hpp"
+
+struct Example {
+    const char* name;
+    std::vector<TaskTiming> tasks;
+};
+
+static TaskTiming ms(int64_t wcet, int64_t period, int64_t deadline = 0, int64_t jitter = 0, int64_t blocking = 0) {
+    constexpr int64_t Ms = 1000000;
+    return TaskTiming{wcet * Ms, period * Ms, deadline * Ms, jitter * Ms, blocking * Ms};
+}
+
+int main() {
+    const std::vector<Example> examples = {
+        {"Ex-0", {ms(1, 2), ms(1, 10), ms(2, 15)}},
+        {"Ex-1", {ms(1, 2), ms(1, 5), ms(2, 7)}},
+        {"Ex-2", {ms(1, 2), ms(1, 5), ms(1, 7), ms(2, 13)}},
+        {"Ex-3", {ms(1, 3), ms(2, 5), ms(3, 15)}},
+        {"Ex-4", {ms(1, 2), ms(1, 4), ms(4, 16)}},
+        {"Ex-0 D<T", {ms(1, 2), ms(1, 10, 3), ms(2, 15, 5)}},
+        {"Ex-3 J=1", {ms(1, 3, 0, 1), ms(2, 5), ms(3, 15)}},
+        {"Ex-4 B=1", {ms(1, 2, 0, 0, 1), ms(1, 4, 0, 0, 1), ms(4, 16)}},
+        {"D>T", {ms(2, 4), ms(3, 6, 9)}},
+        {"D>T DM", {ms(2, 13, 2), ms(2, 8, 16), ms(10, 21, 18)}},
+        // Harmonic at exactly U = 1, which a double sum rounds above 1
+        {"U=1", {ms(2280, 5507), ms(1102, 16521), ms(8418, 49563), ms(32175, 198252), ms(53255, 991260),
+                 ms(529000, 3965040)}},
+    };
+
+    for (const auto& example : examples) {
+        auto analysis = Schedulability::analyze(example.tasks);
+        std::vector<size_t> order;
+        bool assigned = Schedulability::assignPriorities(example.tasks, order);
+        std::printf("%-9s U=%6.2f%%  LUB %-10s hyperbolic %-10s points %-10s RTA %-10s EDF %-10s OPA %s\n",
+                    example.name,
+                    100.0 * Schedulability::utilization(example.tasks),
+                    Schedulability::liuLaylandBound(example.tasks) ? "FEASIBLE" : "INFEASIBLE",
+                    Schedulability::hyperbolicBound(example.tasks) ? "FEASIBLE" : "INFEASIBLE",
+                    Schedulability::schedulingPointFeasible(example.tasks) ? "FEASIBLE" : "INFEASIBLE",
+                    analysis.feasible ? "FEASIBLE" : "INFEASIBLE",
+                    EdfSchedulability::feasible(example.tasks) ? "FEASIBLE" : "INFEASIBLE",
+                    assigned ? "FEASIBLE" : "INFEASIBLE");
+        for (size_t i = 0; i < example.tasks.size(); ++i) {
+            const auto& task = example.tasks[i];
+            std::printf("    S%zu C=%ld T=%ld D=%ld J=%ld B=%ld  R=", i + 1, task.wcetNs / 1000000,
+                        task.periodNs / 1000000, task.deadline() / 1000000, task.jitterNs / 1000000,
+                        task.blockingNs / 1000000);
+            if (analysis.responseNs[i] == Schedulability::Unschedulable) {
+                std::printf("miss\n");
+            } else {
+                std::printf("%ld\n", analysis.responseNs[i] / 1000000);
+            }
+        }
+        if (assigned && !analysis.feasible) {
+            std::printf("    OPA order:");
+            for (size_t i : order) std::printf(" S%zu", i + 1);
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * Monte-Carlo schedulability study: breakdown utilization of random
+ * fixed-priority task sets under the RM/DM tests of Schedulability.hpp,
+ * the C++ versions of exercise2/FeasibilityExampleCode/feasibility_tests.c,
+ * on every core. Replaces the exercise2/SchedExamples spreadsheets for
+ * sizing a board against a period mix.
+ *
+ * Each set gets utilization shares summing to 1 (UUniFast, or
+ * RandFixedSum when -c caps any task's utilization), log-uniform periods
+ * and, with -d, deadlines uniform in [d T, T]; priorities are deadline
+ * monotonic (rate monotonic for D = T). Its breakdown utilization under a
+ * test is the largest total U, scaling every WCET by the same factor, at
+ * which the test still accepts it:
+ *   lub         Liu & Layland, n (2^(1/n) - 1)
+ *   hyperbolic  prod (1 + U_i) <= 2
+ *   exact       response-time analysis, by binary search on U
+ * With D < T the bounds use density C/D in place of C/T, which keeps them
+ * sufficient for DM. All three are found to a resolution of 1e-4.
+ *
+ * CSV on stdout: per utilization, the fraction of sets each test accepts
+ * (the breakdown-utilization curves); summary on stderr. Sets are drawn in
+ * fixed batches, each seeded from -s and its index, so the results do not
+ * depend on the number of threads.
+ *
+ * Build: make sched_study
+ * Run:   ./sched_study [-n tasks] [-N sets] [-p min_ms:max_ms] [-d min_deadline_ratio]
+ *                      [-c max_task_utilization] [-b points] [-j threads] [-s seed] > curves.csv
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "Schedulability.hpp"
+#include "TaskSetGenerator.hpp"
+
+enum Test { Lub, Hyperbolic, Exact, Tests };
+
+static const char* const TestNames[Tests] = {"lub", "hyperbolic", "exact"};
+
+// Breakdown utilization in steps of 1 / Resolution
+static constexpr int64_t Resolution = 10000;
+static constexpr uint64_t BatchSets = 4096;
+
+struct Study {
+    size_t tasks = 10;
+    uint64_t sets = 1000000;
+    int64_t minPeriodNs = 1000000;
+    int64_t maxPeriodNs = 1000000000;
+    double minDeadline = 1.0;
+    double cap = 1.0;
+    int points = 100;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+};
+
+struct Task {
+    double share;   // of the total utilization
+    int64_t periodNs;
+    int64_t deadlineNs;
+};
+
+// Per test, how many sets broke down at each step
+struct Counts {
+    std::vector<uint64_t> breakdowns[Tests];
+
+    Counts()
+    {
+        for (auto& histogram : breakdowns) histogram.assign(Resolution + 1, 0);
+    }
+
+    void merge(const Counts& other)
+    {
+        for (int test = 0; test < Tests; ++test) {
+            for (int64_t step = 0; step <= Resolution; ++step) breakdowns[test][step] += other.breakdowns[test][step];
+        }
+    }
+};
+
+static uint64_t splitMix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+class Worker {
+public:
+    Worker(const Study& study) : _study(study), _generator(study.tasks, 0), _set(study.tasks), _timing(study.tasks) {}
+
+    void run(uint64_t batch, Counts& counts)
+    {
+        _generator.reseed(splitMix(_study.seed ^ splitMix(batch)));
+        uint64_t first = batch * BatchSets;
+        uint64_t last = std::min(_study.sets, first + BatchSets);
+        for (uint64_t set = first; set < last; ++set) {
+            _draw();
+            counts.breakdowns[Lub][_lubBreakdown()]++;
+            int64_t hyperbolic = _hyperbolicBreakdown();
+            counts.breakdowns[Hyperbolic][hyperbolic]++;
+            counts.breakdowns[Exact][_exactBreakdown(hyperbolic)]++;
+        }
+    }
+
+private:
+    const Study& _study;
+    TaskSetGenerator _generator;
+    std::vector<Task> _set;
+    std::vector<TaskTiming> _timing;
+
+    void _draw()
+    {
+        const auto& shares = _study.cap < 1.0 ? _generator.randFixedSum(1.0, _study.cap) : _generator.uuniFast(1.0);
+        for (size_t i = 0; i < _set.size(); ++i) {
+            int64_t period = _generator.logUniform(_study.minPeriodNs, _study.maxPeriodNs);
+            int64_t deadline = period;
+            if (_study.minDeadline < 1.0) {
+                deadline = std::max<int64_t>(1, std::llround(period * _generator.uniform(_study.minDeadline, 1.0)));
+            }
+            _set[i] = Task{shares[i], period, deadline};
+        }
+        std::sort(_set.begin(), _set.end(), [](const Task& a, const Task& b) { return a.deadlineNs < b.deadlineNs; });
+    }
+
+    // Share of the density sum_i C_i / D_i per unit of total utilization
+    double _density() const
+    {
+        double density = 0.0;
+        for (const auto& task : _set) density += task.share * task.periodNs / task.deadlineNs;
+        return density;
+    }
+
+    int64_t _lubBreakdown() const
+    {
+        double n = static_cast<double>(_set.size());
+        double bound = n * (std::pow(2.0, 1.0 / n) - 1.0);
+        return std::min<int64_t>(Resolution, static_cast<int64_t>(bound / _density() * Resolution));
+    }
+
+    int64_t _hyperbolicBreakdown() const
+    {
+        auto accepts = [this](int64_t step) {
+            double u = static_cast<double>(step) / Resolution;
+            double product = 1.0;
+            for (const auto& task : _set) product *= 1.0 + u * task.share * task.periodNs / task.deadlineNs;
+            return product <= 2.0;
+        };
+        return _largestAccepted(0, accepts);
+    }
+
+    // The hyperbolic bound is sufficient, so the search starts there
+    int64_t _exactBreakdown(int64_t hyperbolic)
+    {
+        auto accepts = [this](int64_t step) {
+            double u = static_cast<double>(step) / Resolution;
+            for (size_t i = 0; i < _set.size(); ++i) {
+                const Task& task = _set[i];
+                int64_t wcet = std::max<int64_t>(1, std::llround(u * task.share * static_cast<double>(task.periodNs)));
+                _timing[i] = TaskTiming{wcet, task.periodNs, task.deadlineNs};
+            }
+            return Schedulability::feasible(_timing);
+        };
+        return _largestAccepted(accepts(hyperbolic) ? hyperbolic : 0, accepts);
+    }
+
+    // Largest step in [low, Resolution] accepted, for a monotonic test
+    // that accepts low
+    template <typename Accepts>
+    static int64_t _largestAccepted(int64_t low, Accepts&& accepts)
+    {
+        if (accepts(Resolution)) return Resolution;
+        int64_t high = Resolution;   // rejected
+        while (high - low > 1) {
+            int64_t middle = low + (high - low) / 2;
+            if (accepts(middle)) low = middle;
+            else high = middle;
+        }
+        return low;
+    }
+};
+
+static bool parsePeriods(const char* text, Study& study) {
+    double minMs = 0.0, maxMs = 0.0;
+    if (std::sscanf(text, "%lf:%lf", &minMs, &maxMs) != 2 || minMs <= 0.0 || maxMs < minMs) return false;
+    study.minPeriodNs = std::llround(minMs * 1e6);
+    study.maxPeriodNs = std::llround(maxMs * 1e6);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Study study;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:N:p:d:c:b:j:s:")) != -1) {
+        switch (opt) {
+        case 'n': study.tasks = std::max(1ul, std::strtoul(optarg, nullptr, 10)); break;
+        case 'N': study.sets = std::max(1ull, std::strtoull(optarg, nullptr, 10)); break;
+        case 'p':
+            if (!parsePeriods(optarg, study)) {
+                std::fprintf(stderr, "-p wants min_ms:max_ms\n");
+                return 1;
+            }
+            break;
+        case 'd': study.minDeadline = std::clamp(std::atof(optarg), 0.01, 1.0); break;
+        case 'c': study.cap = std::clamp(std::atof(optarg), 0.0, 1.0); break;
+        case 'b': study.points = std::clamp(std::atoi(optarg), 1, static_cast<int>(Resolution)); break;
+        case 'j': study.threads = static_cast<unsigned>(std::max(1, std::atoi(optarg))); break;
+        case 's': study.seed = std::strtoull(optarg, nullptr, 10); break;
+        default:
+            std::fprintf(stderr,
+                         "Usage: %s [-n tasks] [-N sets] [-p min_ms:max_ms] [-d min_deadline_ratio] "
+                         "[-c max_task_utilization] [-b points] [-j threads] [-s seed]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if (study.cap * static_cast<double>(study.tasks) < 1.0) {
+        std::fprintf(stderr, "-c %.3f: %zu tasks cannot reach U = 1\n", study.cap, study.tasks);
+        return 1;
+    }
+
+    std::fprintf(stderr, "%lu sets of %zu tasks (%s), periods %.3g..%.3g ms, D in [%.2f T, T], %u threads, seed %lu\n",
+                 study.sets, study.tasks, study.cap < 1.0 ? "RandFixedSum" : "UUniFast", study.minPeriodNs / 1e6,
+                 study.maxPeriodNs / 1e6, study.minDeadline, study.threads, study.seed);
+
+    Counts total;
+    std::mutex mutex;
+    std::atomic<uint64_t> nextBatch{0};
+    const uint64_t batches = (study.sets + BatchSets - 1) / BatchSets;
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned t = 0; t < study.threads; ++t) {
+            threads.emplace_back([&] {
+                Worker worker(study);
+                Counts counts;
+                for (uint64_t batch; (batch = nextBatch.fetch_add(1)) < batches;) worker.run(batch, counts);
+                std::lock_guard lock(mutex);
+                total.merge(counts);
+            });
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Fraction of sets accepted at U = breakdowns at or above U
+    std::vector<uint64_t> accepted[Tests];
+    for (int test = 0; test < Tests; ++test) {
+        accepted[test].assign(Resolution + 2, 0);
+        for (int64_t step = Resolution; step >= 0; --step) {
+            accepted[test][step] = accepted[test][step + 1] + total.breakdowns[test][step];
+        }
+    }
+    std::printf("utilization,%s,%s,%s\n", TestNames[Lub], TestNames[Hyperbolic], TestNames[Exact]);
+    for (int point = 0; point <= study.points; ++point) {
+        int64_t step = Resolution * point / study.points;
+        std::printf("%.4f", static_cast<double>(step) / Resolution);
+        for (int test = 0; test < Tests; ++test) {
+            std::printf(",%.6f", static_cast<double>(accepted[test][step]) / static_cast<double>(study.sets));
+        }
+        std::printf("\n");
+    }
+
+    std::fprintf(stderr, "%.2f s, %.0f sets/s\n", seconds, study.sets / seconds);
+    std::fprintf(stderr, "%-11s %9s %9s %9s %9s\n", "breakdown", "mean", "p5", "median", "p95");
+    for (int test = 0; test < Tests; ++test) {
+        double sum = 0.0;
+        for (int64_t step = 0; step <= Resolution; ++step) {
+            sum += static_cast<double>(total.breakdowns[test][step]) * static_cast<double>(step) / Resolution;
+        }
+        auto quantile = [&](double q) {
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(study.sets - 1));
+            uint64_t seen = 0;
+            for (int64_t step = 0; step <= Resolution; ++step) {
+                seen += total.breakdowns[test][step];
+                if (seen > rank) return static_cast<double>(step) / Resolution;
+            }
+            return 1.0;
+        };
+        std::fprintf(stderr, "%-11s %9.4f %9.4f %9.4f %9.4f\n", TestNames[test], sum / static_cast<double>(study.sets),
+                     quantile(0.05), quantile(0.5), quantile(0.95));
+    }
+    return 0;
+}
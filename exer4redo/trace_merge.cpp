@@ -0,0 +1,245 @@
+/*
+ * Merge TraceMarker job markers with the scheduler and irq events of an
+ * ftrace dump into one latency breakdown per job (CSV on stdout).
+ *
+ * Capture:
+ *   cd /sys/kernel/tracing
+ *   echo mono > trace_clock        # same clock as the scheduled releases
+ *   echo 1 > events/sched/sched_wakeup/enable
+ *   echo 1 > events/sched/sched_switch/enable
+ *   echo 1 > events/irq/enable
+ *   ./rt_sequencer -k 5; cat trace > /tmp/ftrace.txt
+ *
+ * Per job (service, scheduled release), all times in us from the scheduled
+ * release: release marker written, service thread woken, switched in, job
+ * started, job ended; plus how often and how long the job was switched out
+ * (preempted or blocked) and how much irq time landed on its CPU while it
+ * ran. If the trace clock is not CLOCK_MONOTONIC the release marker is used
+ * as the origin instead.
+ *
+ * Build: make trace_merge
+ * Run:   ./trace_merge [ftrace_dump] > jobs.csv
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+constexpr int64_t Unset = INT64_MIN;
+
+struct Line {
+    int pid;
+    int cpu;
+    int64_t ns;
+    std::string event;
+    const char* args;
+};
+
+struct Job {
+    uint16_t service;
+    int64_t scheduledNs;
+    int64_t releaseNs = Unset;
+    int64_t wakeupNs = Unset;
+    int64_t switchInNs = Unset;
+    int64_t startNs = Unset;
+    int cpu = -1;
+    int switchOuts = 0;
+    int64_t offCpuNs = 0;
+    int64_t switchedOutAt = Unset;
+    int64_t irqNs = 0;
+};
+
+struct Summary {
+    uint64_t jobs = 0;
+    double maxStartUs = 0;
+    double maxExecUs = 0;
+    uint64_t switchOuts = 0;
+    double irqUs = 0;
+};
+
+// "  task-1234  [001] d..2.  5678.123456: event: args"
+bool parseLine(const char* text, Line& line) {
+    const char* open = std::strchr(text, '[');
+    if (open == nullptr || text[0] == '#') return false;
+
+    const char* dash = open;
+    while (dash > text && *dash != '-') --dash;
+    if (*dash != '-') return false;
+    line.pid = std::atoi(dash + 1);
+    line.cpu = std::atoi(open + 1);
+
+    // Skip the optional flags column to the "<sec>.<frac>:" timestamp
+    const char* p = std::strchr(open, ']');
+    if (p == nullptr) return false;
+    while (true) {
+        while (*p == ' ' || *p == ']') ++p;
+        const char* end = p;
+        while ((*end >= '0' && *end <= '9') || *end == '.') ++end;
+        if (end > p && *end == ':') {
+            const char* dot = std::strchr(p, '.');
+            if (dot == nullptr || dot > end) return false;
+            line.ns = std::strtoll(p, nullptr, 10) * 1000000000;
+            int64_t scale = 100000000;
+            for (const char* d = dot + 1; d < end && scale > 0; ++d, scale /= 10) {
+                line.ns += (*d - '0') * scale;
+            }
+            p = end + 1;
+            break;
+        }
+        while (*p != ' ' && *p != '\0') ++p;
+        if (*p == '\0') return false;
+    }
+
+    while (*p == ' ') ++p;
+    const char* colon = std::strchr(p, ':');
+    if (colon == nullptr) return false;
+    line.event.assign(p, colon);
+    line.args = colon + 1;
+    while (*line.args == ' ') ++line.args;
+    return true;
+}
+
+// Value of "key=<int>" in an event's arguments
+int64_t field(const char* args, const char* key) {
+    size_t keyLength = std::strlen(key);
+    for (const char* p = std::strstr(args, key); p != nullptr; p = std::strstr(p + 1, key)) {
+        if ((p == args || p[-1] == ' ') && p[keyLength] == '=') {
+            return std::strtoll(p + keyLength + 1, nullptr, 10);
+        }
+    }
+    return Unset;
+}
+
+double usSince(int64_t origin, int64_t ns) {
+    return ns == Unset ? -1.0 : (ns - origin) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    FILE* in = stdin;
+    if (argc > 1) {
+        in = std::fopen(argv[1], "r");
+        if (in == nullptr) {
+            std::perror(argv[1]);
+            return 1;
+        }
+    }
+
+    std::map<std::pair<uint16_t, int64_t>, Job> pending;   // released, not yet ended
+    std::unordered_map<int, Job*> running;                 // pid -> job between S and E
+    std::unordered_map<int, int64_t> lastWakeup, lastSwitchIn;
+    std::unordered_map<int, int64_t> irqEntry;             // cpu -> irq_handler_entry
+    std::map<uint16_t, Summary> summary;
+    bool monotonic = true;
+    bool warned = false;
+
+    std::printf("service,scheduled_ns,cpu,release_us,wakeup_us,switch_in_us,start_us,end_us,exec_us,"
+                "switch_outs,off_cpu_us,irq_us\n");
+
+    char text[1024];
+    Line line;
+    while (std::fgets(text, sizeof(text), in) != nullptr) {
+        if (!parseLine(text, line)) continue;
+
+        if (line.event == "tracing_mark_write") {
+            char kind;
+            unsigned service;
+            long long scheduled;
+            if (std::sscanf(line.args, "rtj %c %u %lld", &kind, &service, &scheduled) != 3) continue;
+
+            auto key = std::make_pair(static_cast<uint16_t>(service), static_cast<int64_t>(scheduled));
+            Job& job = pending.try_emplace(key, Job{key.first, key.second}).first->second;
+
+            if (kind == 'R') {
+                job.releaseNs = line.ns;
+                if (std::llabs(line.ns - scheduled) > 1000000000 && !warned) {
+                    std::fprintf(stderr, "trace clock is not CLOCK_MONOTONIC (echo mono > trace_clock); "
+                                         "times are relative to the release marker\n");
+                    monotonic = false;
+                    warned = true;
+                }
+            } else if (kind == 'S') {
+                job.startNs = line.ns;
+                job.cpu = line.cpu;
+                auto wakeup = lastWakeup.find(line.pid);
+                if (wakeup != lastWakeup.end()) job.wakeupNs = wakeup->second;
+                auto switchIn = lastSwitchIn.find(line.pid);
+                if (switchIn != lastSwitchIn.end()) job.switchInNs = switchIn->second;
+                running[line.pid] = &job;
+            } else if (kind == 'E') {
+                running.erase(line.pid);
+                if (job.startNs == Unset) {
+                    pending.erase(key);
+                    continue;
+                }
+
+                int64_t origin = monotonic || job.releaseNs == Unset ? job.scheduledNs : job.releaseNs;
+                double execUs = (line.ns - job.startNs) / 1000.0;
+                std::printf("%u,%ld,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%.3f,%.3f\n",
+                            job.service, job.scheduledNs, job.cpu,
+                            usSince(origin, job.releaseNs), usSince(origin, job.wakeupNs),
+                            usSince(origin, job.switchInNs), usSince(origin, job.startNs),
+                            usSince(origin, line.ns), execUs,
+                            job.switchOuts, job.offCpuNs / 1000.0, job.irqNs / 1000.0);
+
+                auto& svc = summary[job.service];
+                svc.jobs++;
+                if (usSince(origin, job.startNs) > svc.maxStartUs) svc.maxStartUs = usSince(origin, job.startNs);
+                if (execUs > svc.maxExecUs) svc.maxExecUs = execUs;
+                svc.switchOuts += job.switchOuts;
+                svc.irqUs += job.irqNs / 1000.0;
+                pending.erase(key);
+            }
+        } else if (line.event == "sched_wakeup") {
+            int64_t pid = field(line.args, "pid");
+            if (pid != Unset) lastWakeup[static_cast<int>(pid)] = line.ns;
+        } else if (line.event == "sched_switch") {
+            int64_t prev = field(line.args, "prev_pid");
+            int64_t next = field(line.args, "next_pid");
+            if (prev != Unset) {
+                auto job = running.find(static_cast<int>(prev));
+                if (job != running.end()) {
+                    job->second->switchOuts++;
+                    job->second->switchedOutAt = line.ns;
+                }
+            }
+            if (next != Unset) {
+                lastSwitchIn[static_cast<int>(next)] = line.ns;
+                auto job = running.find(static_cast<int>(next));
+                if (job != running.end() && job->second->switchedOutAt != Unset) {
+                    job->second->offCpuNs += line.ns - job->second->switchedOutAt;
+                    job->second->switchedOutAt = Unset;
+                }
+            }
+        } else if (line.event == "irq_handler_entry" || line.event == "softirq_entry") {
+            irqEntry[line.cpu] = line.ns;
+        } else if (line.event == "irq_handler_exit" || line.event == "softirq_exit") {
+            auto entry = irqEntry.find(line.cpu);
+            auto job = running.find(line.pid);
+            if (entry != irqEntry.end() && job != running.end()) {
+                job->second->irqNs += line.ns - entry->second;
+            }
+            irqEntry.erase(line.cpu);
+        }
+    }
+
+    if (in != stdin) std::fclose(in);
+
+    for (const auto& [service, svc] : summary) {
+        std::fprintf(stderr, "service %u: %lu jobs, max start %.1f us, max exec %.1f us, "
+                             "%lu switch-outs, %.1f us irq\n",
+                     service, svc.jobs, svc.maxStartUs, svc.maxExecUs, svc.switchOuts, svc.irqUs);
+    }
+    if (summary.empty()) {
+        std::fprintf(stderr, "no rtj job markers found (run with -k while tracing is on)\n");
+        return 1;
+    }
+    return 0;
+}
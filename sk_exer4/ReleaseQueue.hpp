@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////
+// Indexed d-ary min-heap
+////////////////////////////////////////////
+// Keeps one key (e.g. nextRelease) per id (e.g. index into the services
+// vector) and always knows the smallest one:
+//   topId()/topKey()   O(1)
+//   updateTop()/update() O(log_d n)
+// Storage is reserved up front; nothing below allocates after reserve(),
+// so onAlarm() on the real-time sigwaitinfo() dispatcher thread never
+// waits on the allocator.
+template <typename Key, unsigned Arity = 4>
+class IndexedMinHeap
+{
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+public:
+    void reserve(size_t n)
+    {
+        heap.reserve(n);
+        pos.reserve(n);
+    }
+
+    void clear()
+    {
+        heap.clear();
+        pos.clear();
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    // ids must be added densely: 0, 1, 2, ...
+    void push(uint32_t id, Key key)
+    {
+        if (pos.size() <= id) pos.resize(id + 1);
+        pos[id] = heap.size();
+        heap.push_back({std::move(key), id});
+        siftUp(heap.size() - 1);
+    }
+
+    uint32_t topId() const { return heap.front().id; }
+    const Key& topKey() const { return heap.front().key; }
+    const Key& key(uint32_t id) const { return heap[pos[id]].key; }
+
+    // Change the key of the minimum element (the common dispatch case:
+    // the earliest release was handled and moved one period forward)
+    void updateTop(Key key)
+    {
+        heap.front().key = std::move(key);
+        siftDown(0);
+    }
+
+    void update(uint32_t id, Key key)
+    {
+        size_t i = pos[id];
+        bool decreased = key < heap[i].key;
+        heap[i].key = std::move(key);
+        if (decreased) siftUp(i);
+        else siftDown(i);
+    }
+
+private:
+    struct Node
+    {
+        Key key;
+        uint32_t id;
+    };
+
+    std::vector<Node> heap;     // heap order, keys stored inline for locality
+    std::vector<size_t> pos;    // id -> index in heap
+
+    void place(size_t i, Node node)
+    {
+        pos[node.id] = i;
+        heap[i] = std::move(node);
+    }
+
+    void siftUp(size_t i)
+    {
+        Node node = std::move(heap[i]);
+        while (i > 0)
+        {
+            size_t parent = (i - 1) / Arity;
+            if (!(node.key < heap[parent].key)) break;
+            place(i, std::move(heap[parent]));
+            i = parent;
+        }
+        place(i, std::move(node));
+    }
+
+    void siftDown(size_t i)
+    {
+        Node node = std::move(heap[i]);
+        size_t n = heap.size();
+        while (true)
+        {
+            size_t first = i * Arity + 1;
+            if (first >= n) break;
+
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t best = first;
+            for (size_t c = first + 1; c < last; c++)
+            {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+
+            if (!(heap[best].key < node.key)) break;
+            place(i, std::move(heap[best]));
+            i = best;
+        }
+        place(i, std::move(node));
+    }
+};
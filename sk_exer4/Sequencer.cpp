@@ -1,34 +1,40 @@
 #include "Sequencer.hpp"
-#include <cstring>    // memset
+#include <cstring>    // strerror
+#include <algorithm>
 #include <cerrno>
+#include <cstdio>
 #include <unistd.h>   // usleep
 
-Sequencer* Sequencer::gInstance = nullptr;
-
 ////////////////////////////////////////////
 // Constructors / Destructors
 ////////////////////////////////////////////
 
 
 Sequencer::Sequencer()
+    : dispatcherPriority(sched_get_priority_max(SCHED_FIFO))
 {
-     // Make this instance globally accessible for static signal handler
-    gInstance = this;
+    // Block the timer and Ctrl+C signals here; service threads created by
+    // addService() inherit the mask and only the dispatcher will accept them
+    sigemptyset(&dispatchSignals);
+    sigaddset(&dispatchSignals, SIGALRM);
+    sigaddset(&dispatchSignals, SIGINT);
+    pthread_sigmask(SIG_BLOCK, &dispatchSignals, nullptr);
+
+    // All statistics are timestamped with RtClock; calibrate it once
+    RtClock::init();
 }
 
 Sequencer::~Sequencer()
 {
     // Ensure timer is torn down
     stopServices();
-    // Unset the global pointer
-    gInstance = nullptr;
 }
 
 ////////////////////////////////////////////
 // Public API
 ////////////////////////////////////////////
 
-void Sequencer::addService(std::string name, std::function<void()> func, int priority, int cpuAffinity, int periodMs)
+void Sequencer::addService(std::string name, ServiceFunction func, int priority, int cpuAffinity, int periodMs)
 {
     auto svc = std::make_unique<Service>();
     svc->serviceFunc = std::move(func);
@@ -36,6 +42,7 @@ void Sequencer::addService(std::string name, std::function<void()> func, int pri
     svc->priority = priority;
     svc->cpuAffinity = cpuAffinity;
     svc->periodMs = periodMs;
+    svc->id = static_cast<uint16_t>(services.size());
 
     // The jthread constructor spawns the thread immediately. We'll store it in the Service struct.
     svc->worker = std::jthread([svcPtr = svc.get()] {
@@ -47,75 +54,150 @@ void Sequencer::addService(std::string name, std::function<void()> func, int pri
         while (svcPtr->keepRunning)
         {
             // Wait for release
-            svcPtr->releaseSem.acquire();
+            auto delivery = svcPtr->release.wait();
 
             if (!svcPtr->keepRunning) break;
 
-            // Mark release time
-            auto releaseTime = std::chrono::steady_clock::now();
+            // Releases lost to an overrun, plus those the dispatcher skipped
+            uint64_t missedReleases = delivery.releases - 1;
+            if (delivery.record.skipped > svcPtr->skippedSeen)
+            {
+                missedReleases += delivery.record.skipped - svcPtr->skippedSeen;
+                svcPtr->skippedSeen = delivery.record.skipped;
+            }
+
+            // Mark release time; the stamps are those of the release taken
+            auto releaseTime = RtClock::now();
+            auto scheduled = delivery.record.scheduled;
+            auto deadline = scheduled + std::chrono::milliseconds(svcPtr->periodMs);
+            auto handlerTime = delivery.record.handler;
+            auto postTime = delivery.record.post;
 
-            // Calculate release jitter vs. planned nextRelease
+            // Calculate release jitter vs. the planned release of this job
             auto relJitterNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                    releaseTime - svcPtr->nextRelease).count();
+                                    releaseTime - scheduled).count();
             svcPtr->stats.updateReleaseJitter(relJitterNs < 0 ? 0 : relJitterNs);
 
             // Run the service function
-            auto startTime = std::chrono::steady_clock::now();
+            auto scheduledNs = scheduled.time_since_epoch().count();
+            TraceMarker::jobStart(svcPtr->id, scheduledNs);
+            auto startTime = RtClock::now();
             svcPtr->serviceFunc();
-            auto endTime = std::chrono::steady_clock::now();
+            auto endTime = RtClock::now();
+            TraceMarker::jobEnd(svcPtr->id, scheduledNs);
+
+            // Release path stages, recorded after the job
+            svcPtr->releaseStages.record(scheduled, handlerTime, postTime, releaseTime, startTime);
 
             // Execution time
             auto execTimeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
                                   endTime - startTime).count();
             svcPtr->stats.updateExecTime(execTimeNs);
+            svcPtr->stats.updateResponseTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                 endTime - scheduled).count());
 
-            // Check for deadline miss
-            if (endTime > svcPtr->nextDeadline)
+            // Check for deadline miss, against the deadline of the release
+            // taken (the dispatcher has usually moved on by now)
+            bool missed = endTime > deadline;
+            if (missed)
             {
                 svcPtr->stats.missDeadline();
             }
+            if (missedReleases > 0)
+            {
+                svcPtr->stats.missReleases(missedReleases);
+            }
+
+            if (svcPtr->trace != nullptr)
+            {
+                uint32_t flags = missed ? uint32_t{JobEvent::DeadlineMiss} : 0u;
+                if (missedReleases > 0) flags |= JobEvent::MissedRelease;
+                svcPtr->trace->push(JobEvent{
+                    scheduledNs,
+                    startTime.time_since_epoch().count(),
+                    endTime.time_since_epoch().count(),
+                    0, static_cast<uint16_t>(sched_getcpu()),
+                    flags});
+            }
         }
     });
 
     services.push_back(std::move(svc));
 }
 
+void Sequencer::setDispatcher(int priority, int cpuAffinity)
+{
+    dispatcherPriority = priority;
+    dispatcherAffinity = cpuAffinity;
+}
+
 void Sequencer::startServices(int masterIntervalMs)
 {
-    // sort services by period, low to high
-    std::sort(services.begin(), services.end(), [](const std::unique_ptr<Service>& a, const std::unique_ptr<Service>& b) {
-        return a->periodMs < b->periodMs;
-    });
+    prepareServices();
+
+    // The dispatcher must be waiting before the first expiry is queued
+    oneShot = false;
+    startDispatcher();
+    setupTimer(masterIntervalMs);
+}
 
-    // Reset "nextRelease" for each service to "now"
-    auto now = std::chrono::steady_clock::now();
+void Sequencer::startServices()
+{
+    prepareServices();
+
+    // Every service is due at "now", so the first expiry is immediate
+    oneShot = true;
+    startDispatcher();
+    setupTimer(0);
+    if (!releaseQueue.empty())
+    {
+        armTimerAt(releaseQueue.topKey());
+    }
+}
+
+void Sequencer::enableTrace(const std::string& path, TraceRecorder::Config config)
+{
+    trace = std::make_unique<TraceRecorder>(path, config);
     for (auto &svc : services)
     {
-        svc->nextRelease = now; 
-        // If you want each service to have a distinct nextDeadline = now + period, do:
-        svc->nextDeadline = now + std::chrono::milliseconds(svc->periodMs);
+        svc->trace = &trace->addRing();
     }
+}
 
-    // Setup signals and timer
-    setupTimer(masterIntervalMs);
+void Sequencer::prepareServices()
+{
+    if (trace && !trace->start())
+    {
+        for (auto &svc : services)
+        {
+            svc->trace = nullptr;
+        }
+        trace.reset();
+    }
 
-    // Also handle Ctrl+C gracefully
-    struct sigaction saInt;
-    memset(&saInt, 0, sizeof(saInt));
-    saInt.sa_handler = Sequencer::sigintHandler;
-    sigaction(SIGINT, &saInt, nullptr);
+    // Reset "nextRelease" for each service to "now" and queue it
+    auto now = RtClock::now();
+    releaseQueue.clear();
+    releaseQueue.reserve(services.size());
+    for (size_t i = 0; i < services.size(); i++)
+    {
+        auto &svc = services[i];
+        svc->nextRelease = now; 
+        releaseQueue.push(static_cast<uint32_t>(i), svc->nextRelease);
+    }
 }
 
 void Sequencer::stopServices()
 {
-    // Cancel timer
+    // Stop releasing first, then cancel timer
+    stopDispatcher();
     teardownTimer();
 
-    // Mark keepRunning = false, release all semaphores
+    // Mark keepRunning = false, release every service once more
     for (auto &svc : services)
     {
         svc->keepRunning = false;
-        svc->releaseSem.release(); // unblock the thread
+        svc->release.post({}); // unblock the thread
     }
 
     // Join all jthreads
@@ -126,49 +208,61 @@ void Sequencer::stopServices()
             svc->worker.join();
         }
     }
+
+    if (trace)
+    {
+        trace->stop();
+    }
 }
 
 void Sequencer::onAlarm()
 {
     // This is called each time SIGALRM fires
-    auto now = std::chrono::steady_clock::now();
-    size_t count = services.size();
+    auto now = RtClock::now();
+    bool released = false;
 
-    for (size_t i=0; i < count; i++)  //auto &svc : services)
-    {
-        // initialize next starting service idx and svc object
-        size_t idx = (nextServiceIndex + i) % count;
-        Service* svc = services[idx].get();
+    alarmCount++;
 
-        // Check if time to release
-        if (now >= svc->nextRelease)
+    // Only the services at the top of the queue can be due
+    while (!releaseQueue.empty() && releaseQueue.topKey() <= now)
+    {
+        Service* svc = services[releaseQueue.topId()].get();
+
+        // Update nextRelease
+        auto scheduled = svc->nextRelease;
+        svc->nextRelease += std::chrono::milliseconds(svc->periodMs);
+        // If we fell behind, we might need to keep pushing nextRelease
+        // forward; the job released now counts those releases as missed
+        while (now >= svc->nextRelease)
         {
-            // Release the service
-            svc->releaseSem.release();
-
-            // Update nextRelease
             svc->nextRelease += std::chrono::milliseconds(svc->periodMs);
-            // If we fell behind, we might need to keep pushing nextRelease forward
-            while (now >= svc->nextRelease)
-            {
-                svc->nextRelease += std::chrono::milliseconds(svc->periodMs);
-            }
-
-            // Update nextDeadline
-            svc->nextDeadline = svc->nextRelease
-                                + std::chrono::milliseconds(svc->periodMs);
-        }
-        else {
-            // when we find a svc that's not due, we save it as the next starting pt.
-            nextServiceIndex = idx;
-            break;
+            svc->skippedReleases++;
         }
+
+        // Release it with the stamps of this release
+        svc->release.post(ReleaseRecord{scheduled, now, RtClock::now(), svc->skippedReleases});
+        TraceMarker::release(svc->id, scheduled.time_since_epoch().count());
+        released = true;
+
+        releaseQueue.updateTop(svc->nextRelease);
+    }
+
+    if (!released)
+    {
+        idleAlarmCount++;
+    }
+
+    // In one-shot mode the next expiry is exactly the next release
+    if (oneShot && !releaseQueue.empty())
+    {
+        armTimerAt(releaseQueue.topKey());
     }
 }
 
 void Sequencer::printStatistics()
 {
-    std::cout << "\n===== Final Statistics =====\n";
+    std::cout << "\n===== Final Statistics =====\n"
+              << "Timestamps: " << RtClock::sourceName() << "\n";
     for (auto &svc : services)
     {
         auto &st = svc->stats;
@@ -182,7 +276,47 @@ void Sequencer::printStatistics()
                   << "   ReleaseJit: min=" << st.minReleaseJitterNs.load() / 1e6 << " ms, "
                   << "max=" << st.maxReleaseJitterNs.load() / 1e6 << " ms, "
                   << "avg=" << st.avgReleaseJitterNs() / 1e6 << " ms\n"
-                  << "   Deadline Misses=" << st.deadlineMissCount.load() << "\n";
+                  << "   Deadline Misses=" << st.deadlineMissCount.load()
+                  << ", Missed Releases=" << st.missedReleaseCount.load() << "\n";
+    }
+    std::cout << "Timer (" << (oneShot ? "one-shot" : "master tick") << "): "
+              << alarmCount.load() << " expiries, "
+              << idleAlarmCount.load() << " released nothing, "
+              << timerOverrunCount.load() << " overruns\n"
+              << "Dispatch latency: min=" << dispatchLatency.minReleaseJitterNs.load() / 1e6 << " ms, "
+              << "max=" << dispatchLatency.maxReleaseJitterNs.load() / 1e6 << " ms, "
+              << "avg=" << dispatchLatency.avgReleaseJitterNs() / 1e6 << " ms\n";
+
+    // Percentile tables, per service and merged over all services
+    LatencyHistogram allExec, allJitter, allResponse;
+    std::cout << "Latency percentiles:\n" << std::flush;
+    LatencyHistogram::printPercentileHeader();
+    for (auto &svc : services)
+    {
+        auto &st = svc->stats;
+        st.releaseJitterHist.printPercentileRow((svc->name + " release").c_str());
+        st.execTimeHist.printPercentileRow((svc->name + " exec").c_str());
+        st.responseTimeHist.printPercentileRow((svc->name + " response").c_str());
+        allJitter.merge(st.releaseJitterHist);
+        allExec.merge(st.execTimeHist);
+        allResponse.merge(st.responseTimeHist);
+    }
+    allJitter.printPercentileRow("all release");
+    allExec.printPercentileRow("all exec");
+    allResponse.printPercentileRow("all response");
+    dispatchLatency.releaseJitterHist.printPercentileRow("dispatch latency");
+    for (auto &svc : services)
+    {
+        std::printf("  release path, %s:\n", svc->name.c_str());
+        svc->releaseStages.printRows();
+    }
+    std::fflush(stdout);
+    if (trace)
+    {
+        std::cout << "Trace: " << trace->eventsWritten() << " jobs, "
+                  << trace->eventsDropped() << " dropped, "
+                  << trace->bytesWritten() << " bytes, "
+                  << trace->rotations() << " rotations\n";
     }
     std::cout << "============================\n\n";
 }
@@ -193,68 +327,158 @@ void Sequencer::printStatistics()
 
 void Sequencer::setupTimer(int masterIntervalMs)
 {
-    // We use SIGALRM for the periodic timer
-    struct sigaction sa;
-    memset(&sa, 0, sizeof(sa));
-    sa.sa_handler = Sequencer::alarmHandler;
-    sigaction(SIGALRM, &sa, nullptr);
+    // SIGALRM stays blocked; there is no handler, dispatchLoop() waits for it
+    this->masterIntervalMs = masterIntervalMs;
 
-    // Create POSIX timer
+    // Create POSIX timer on the same clock as steady_clock, so one-shot
+    // expiries can be armed at an absolute nextRelease
     sigevent sev{};
     sev.sigev_notify = SIGEV_SIGNAL;
     sev.sigev_signo = SIGALRM;
 
-    if (timer_create(CLOCK_REALTIME, &sev, &timerId) < 0)
+    if (timer_create(CLOCK_MONOTONIC, &sev, &timerId) < 0)
     {
         std::cerr << "timer_create error: " << strerror(errno) << "\n";
         return;
     }
+    timerValid = true;
+
+    if (masterIntervalMs <= 0) return;
 
-    // Start periodic timer
+    // Start periodic timer, first expiry one interval from now. It is armed
+    // at an absolute time so the dispatcher knows exactly when each tick is due
+    expectedExpiry = RtClock::now()
+                     + std::chrono::milliseconds(masterIntervalMs);
+    auto firstNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       expectedExpiry.time_since_epoch()).count();
     itimerspec its{};
     // initial expiration
-    its.it_value.tv_sec = masterIntervalMs / 1000;
-    its.it_value.tv_nsec = (masterIntervalMs % 1000) * 1000000;
+    its.it_value.tv_sec = firstNs / 1000000000;
+    its.it_value.tv_nsec = firstNs % 1000000000;
     // interval for periodic
-    its.it_interval.tv_sec = its.it_value.tv_sec;
-    its.it_interval.tv_nsec = its.it_value.tv_nsec;
+    its.it_interval.tv_sec = masterIntervalMs / 1000;
+    its.it_interval.tv_nsec = (masterIntervalMs % 1000) * 1000000;
 
-    if (timer_settime(timerId, 0, &its, nullptr) < 0)
+    if (timer_settime(timerId, TIMER_ABSTIME, &its, nullptr) < 0)
     {
         std::cerr << "timer_settime error: " << strerror(errno) << "\n";
     }
 }
 
+void Sequencer::armTimerAt(std::chrono::steady_clock::time_point when)
+{
+    if (!timerValid) return;
+
+    expectedExpiry = when;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(when.time_since_epoch()).count();
+    itimerspec its{};
+    its.it_value.tv_sec = ns / 1000000000;
+    its.it_value.tv_nsec = ns % 1000000000;
+
+    // An all-zero it_value would disarm the timer rather than fire it
+    if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0)
+    {
+        its.it_value.tv_nsec = 1;
+    }
+
+    timer_settime(timerId, TIMER_ABSTIME, &its, nullptr);
+}
+
 void Sequencer::teardownTimer()
 {
-    if (timerId != nullptr)
+    if (timerValid)
     {
+        timerValid = false;
         timer_delete(timerId);
         timerId = nullptr;
     }
 }
 
-void Sequencer::alarmHandler(int signo)
+void Sequencer::startDispatcher()
+{
+    dispatcherStop = false;
+    dispatcher = std::jthread([this] {
+        setCurrentThreadAffinity(dispatcherAffinity);
+        setCurrentThreadPriority(dispatcherPriority);
+        dispatchLoop();
+    });
+}
+
+void Sequencer::stopDispatcher()
 {
-    if (signo == SIGALRM && gInstance)
+    if (!dispatcher.joinable()) return;
+
+    // Wake the dispatcher out of sigwaitinfo(); it checks the flag first
+    dispatcherStop = true;
+    if (dispatcher.get_id() == std::this_thread::get_id())
     {
-        gInstance->onAlarm();
+        // Called from onSigint() on the dispatcher itself
+        dispatcher.detach();
+        return;
     }
+    pthread_kill(dispatcher.native_handle(), SIGALRM);
+    dispatcher.join();
 }
 
-void Sequencer::sigintHandler(int signo)
+void Sequencer::dispatchLoop()
 {
-    if (signo == SIGINT && gInstance)
+    while (!dispatcherStop)
     {
-        std::cout << "\nSIGINT received -> Stopping services...\n";
-        gInstance->stopServices();
-        // Pint final stats
-        gInstance->printStatistics();
-        // Then exit
-        std::_Exit(EXIT_SUCCESS);
+        siginfo_t info;
+        int signo = sigwaitinfo(&dispatchSignals, &info);
+        if (signo < 0)
+        {
+            if (errno == EINTR) continue;
+            std::cerr << "sigwaitinfo error: " << strerror(errno) << "\n";
+            break;
+        }
+
+        if (dispatcherStop) break;
+
+        if (signo == SIGINT)
+        {
+            onSigint();
+            break;
+        }
+
+        if (info.si_code != SI_TIMER) continue;
+
+        // Wakeup latency vs. the expiry we armed (or the tick we expected)
+        auto now = RtClock::now();
+        dispatchLatency.updateReleaseJitter(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - expectedExpiry).count());
+
+        // Expiries that happened while the previous signal was still pending
+        int overruns = timer_getoverrun(timerId);
+        if (overruns > 0)
+        {
+            timerOverrunCount += overruns;
+        }
+
+        if (!oneShot)
+        {
+            expectedExpiry += std::chrono::milliseconds(masterIntervalMs) * (1 + std::max(overruns, 0));
+        }
+
+        onAlarm();
+
+        // Re-check the timestamp counter against CLOCK_MONOTONIC now and then
+        RtClock::verifyIfDue();
     }
 }
 
+void Sequencer::onSigint()
+{
+    // Runs on the dispatcher thread, so iostream and joins are fine here
+    std::cout << "\nSIGINT received -> Stopping services...\n";
+    stopServices();
+    // Pint final stats
+    printStatistics();
+    // Then exit (_Exit does not flush, so flush what we printed first)
+    std::cout.flush();
+    std::_Exit(EXIT_SUCCESS);
+}
+
 void Sequencer::setCurrentThreadAffinity(int cpuCore)
 {
     if (cpuCore < 0) return;
@@ -2,13 +2,12 @@
 
 #include <atomic>
 #include <cstdint>
-#include <functional>
 #include <iostream>
+#include <string>
 #include <thread>
 #include <chrono>
 #include <vector>
 #include <csignal>
-#include <semaphore>
 #include <memory>
 #include <mutex>
 #include <condition_variable>
@@ -17,6 +16,15 @@
 #include <pthread.h>
 #include <sched.h>
 
+#include "FutexRelease.hpp"
+#include "InplaceFunction.hpp"
+#include "LatencyHistogram.hpp"
+#include "ReleaseQueue.hpp"
+#include "ReleaseStages.hpp"
+#include "RtClock.hpp"
+#include "TraceMarker.hpp"
+#include "TraceRecorder.hpp"
+
 ////////////////////////////////////////////
 // Real-Time Statistics
 //////////////////////////////////////////
@@ -44,6 +52,12 @@ struct RTStatistics
 
     // Deadline stats
     std::atomic<long long> deadlineMissCount{0};
+    std::atomic<long long> missedReleaseCount{0};   // releases that came while the previous job still ran, or were skipped
+
+    // Full distributions (ns) for percentile tables
+    LatencyHistogram execTimeHist;
+    LatencyHistogram releaseJitterHist;
+    LatencyHistogram responseTimeHist;
 
     void updateExecTime(long long execNs)
     {
@@ -59,6 +73,7 @@ struct RTStatistics
 
         totalExecNs += execNs;
         count++;
+        execTimeHist.record(execNs);
 
         //exec jitter calc after first execution is over
         if (count > 1) {
@@ -89,9 +104,14 @@ struct RTStatistics
 
         totalReleaseJitterNs += jitterNs;
         releaseCount++;
+        releaseJitterHist.record(jitterNs);
     }
 
+    // Completion time relative to the planned release of the job
+    void updateResponseTime(long long responseNs) { responseTimeHist.record(responseNs); }
+
     void missDeadline() { deadlineMissCount++; }
+    void missReleases(long long n) { missedReleaseCount += n; }
 
     // Helpers to get final stats
     double avgExecNs() const
@@ -114,86 +134,160 @@ struct RTStatistics
 ////////////////////////////////////////////
 // Service Configuration
 ////////////////////////////////////////////
+// Job body, stored inline in the Service (no heap allocation)
+using ServiceFunction = InplaceFunction<void(), 64>;
+
+// Stamps of one release, handed to the worker together with it
+struct ReleaseRecord
+{
+    std::chrono::steady_clock::time_point scheduled;   // planned release instant
+    std::chrono::steady_clock::time_point handler;     // when onAlarm() ran
+    std::chrono::steady_clock::time_point post;        // when onAlarm() posted it
+    uint64_t skipped;   // running total of releases onAlarm() fell too far behind to make
+};
+
 struct Service
 {
-    std::function<void()> serviceFunc;
+    ServiceFunction serviceFunc;
     int priority;       // e.g. 98, 99 for RT
     int cpuAffinity;    // which CPU core to run on, or -1 for no affinity
     std::string name; 
+    uint16_t id{0};     // index in the Sequencer, used in trace markers
     int periodMs;       // how often (in ms) to release
     bool keepRunning{true};
 
-    // Use a counting semaphore for release signals
-    std::counting_semaphore<1> releaseSem{0};
+    // Release signal carrying its ReleaseRecord; wait() also reports
+    // releases missed by an overrun
+    FutexMailbox<ReleaseRecord> release;
 
     // jthread for the service
     std::jthread worker;
 
     // Real-time stats
     RTStatistics stats;
+    ReleaseStages releaseStages;
+
+    // Per-job trace, set by Sequencer::enableTrace()
+    TraceRing* trace{nullptr};
 
-    // For release/deadline tracking
+    // For release/deadline tracking (dispatcher side)
     std::chrono::steady_clock::time_point nextRelease;
-    std::chrono::steady_clock::time_point nextDeadline;
+    uint64_t skippedReleases{0};
+
+    // ReleaseRecord::skipped already counted (worker side)
+    uint64_t skippedSeen{0};
 };
 
 ////////////////////////////////////////////
 // Sequencer Class
 ////////////////////////////////////////////
+// SIGALRM and SIGINT are never handled in signal context. The constructor
+// blocks them in the calling thread, so every thread created afterwards
+// (all service workers) inherits the mask, and a dedicated SCHED_FIFO
+// dispatcher thread consumes them with sigwaitinfo(). Construct the
+// Sequencer before starting any other threads.
 class Sequencer
 {
 public:
     Sequencer();
     ~Sequencer();
 
+    // Dispatcher thread settings, applied when services are started
+    //  priority = SCHED_FIFO priority, defaults to the maximum
+    //  cpuAffinity = core to pin the dispatcher to, or -1 to disable
+    void setDispatcher(int priority, int cpuAffinity);
+
     // Adds a service. 
     //  func = user code to run
     //  priority = e.g. 98 or 99 (SCHED_FIFO)
     //  cpuAffinity = e.g. 0 for CPU0, or -1 to disable
     //  periodMs = desired period in milliseconds
-void addService(std::string name, std::function<void()> func, int priority, int cpuAffinity, int periodMs);
+void addService(std::string name, ServiceFunction func, int priority, int cpuAffinity, int periodMs);
 
     // Start all services with an underlying POSIX timer that ticks at `masterIntervalMs`
     // and calls onAlarm() each time. onAlarm() will handle releasing services.
     void startServices(int masterIntervalMs);
 
+    // Start all services with a one-shot timer instead of a master tick.
+    // onAlarm() re-arms the timer for the earliest nextRelease after each
+    // dispatch, so releases are not quantized to a tick and the CPU is only
+    // woken when a service is actually due.
+    void startServices();
+
     // Gracefully stop all services and cancel the timer
     void stopServices();
 
-    // Called from the signal handler when SIGALRM fires
+    // Called from the dispatcher thread when SIGALRM is received
     // This checks if it’s time to release each service
     void onAlarm();
 
     // Print final stats
     void printStatistics();
 
+    // Stream every job of every service added so far to path (see
+    // TraceRecorder.hpp). Call after addService and before startServices.
+    void enableTrace(const std::string& path, TraceRecorder::Config config = {});
+
 private:
+    // Declared before services so the rings outlive the worker threads
+    std::unique_ptr<TraceRecorder> trace;
+
     // We store all Service objects
     std::vector<std::unique_ptr<Service>> services;
 
+    // Services (by index) ordered by nextRelease, so onAlarm() only touches
+    // the services that are due instead of walking the whole list
+    IndexedMinHeap<std::chrono::steady_clock::time_point> releaseQueue;
+
     // For POSIX timer
     timer_t timerId{nullptr};
+    bool timerValid{false};   // glibc hands out kernel timer id 0 as a null timer_t
+    bool oneShot{false};
+
+    int masterIntervalMs{0};
+
+    // Timer expiries, and how many of them released nothing
+    std::atomic<long long> alarmCount{0};
+    std::atomic<long long> idleAlarmCount{0};
+
+    // Expiries the kernel coalesced into one signal (timer_getoverrun)
+    std::atomic<long long> timerOverrunCount{0};
+
+    // When the timer is expected to expire next; the dispatcher measures its
+    // wakeup latency against this (reported through updateReleaseJitter)
+    std::chrono::steady_clock::time_point expectedExpiry;
+    RTStatistics dispatchLatency;
 
-    // This is used in the static signal handler
-    static Sequencer* gInstance;
+    // Signal dispatcher thread
+    sigset_t dispatchSignals;
+    std::jthread dispatcher;
+    std::atomic<bool> dispatcherStop{false};
+    int dispatcherPriority;
+    int dispatcherAffinity{0};
+
+    // Reset release times and queue the services
+    void prepareServices();
+
+    // Start the dispatcher thread that waits for SIGALRM/SIGINT
+    void startDispatcher();
+    void stopDispatcher();
+    void dispatchLoop();
 
     // Setup the real-time timer for SIGALRM
+    // masterIntervalMs > 0 arms a periodic tick, 0 leaves the timer disarmed
     void setupTimer(int masterIntervalMs);
 
+    // One-shot mode: arm the timer to expire at an absolute time
+    void armTimerAt(std::chrono::steady_clock::time_point when);
+
     // Cancel the timer
     void teardownTimer();
 
-    // Called once by signal handler
-    static void alarmHandler(int signo);
-
     // We also want a clean shutdown on CTRL+C
-    static void sigintHandler(int signo);
+    void onSigint();
 
     // Utility: set the affinity & priority for the calling thread
     static void setCurrentThreadAffinity(int cpuCore);
     static void setCurrentThreadPriority(int priority);
-
-    //remember current position in sorted services list (vector?)
-    size_t nextServiceIndex{0};
 };
 
@@ -0,0 +1,166 @@
+// Dispatch cost of onAlarm() release selection: linear pass over all
+// services vs. the indexed d-ary heap in ReleaseQueue.hpp.
+//
+// Time is simulated (no timer, no threads) so only the selection logic is
+// measured: every "alarm" happens at the earliest nextRelease, releases all
+// due services, moves them one period forward and finds the next expiry.
+//
+// Build: make bench_release_queue
+// Run:   ./bench_release_queue [releases_per_size]
+
+#include "ReleaseQueue.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+struct SimService
+{
+    int64_t periodNs;
+    int64_t nextRelease;
+    uint64_t releases;
+};
+
+struct Result
+{
+    double nsPerAlarm;
+    double nsPerRelease;
+    uint64_t checksum;
+};
+
+std::vector<SimService> makeServices(size_t n, uint32_t seed)
+{
+    // Periods 1 ms .. 1000 ms in whole ms, like addService(periodMs), with
+    // random phasing so releases are spread out rather than all at t=0
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int64_t> periodMs(1, 1000);
+
+    std::vector<SimService> services(n);
+    for (auto &svc : services)
+    {
+        svc.periodNs = periodMs(rng) * 1000000;
+        svc.nextRelease = std::uniform_int_distribution<int64_t>(0, svc.periodNs - 1)(rng);
+        svc.releases = 0;
+    }
+    return services;
+}
+
+// Same shape as a full-pass onAlarm(): look at every service each expiry
+Result runLinear(std::vector<SimService> services, uint64_t targetReleases)
+{
+    uint64_t released = 0, alarms = 0;
+    int64_t now = std::numeric_limits<int64_t>::max();
+    for (auto &svc : services)
+    {
+        if (svc.nextRelease < now) now = svc.nextRelease;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while (released < targetReleases)
+    {
+        int64_t earliest = std::numeric_limits<int64_t>::max();
+        for (auto &svc : services)
+        {
+            if (now >= svc.nextRelease)
+            {
+                svc.releases++;
+                released++;
+                svc.nextRelease += svc.periodNs;
+            }
+            if (svc.nextRelease < earliest) earliest = svc.nextRelease;
+        }
+        alarms++;
+        now = earliest;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    uint64_t checksum = 0;
+    for (auto &svc : services) checksum += svc.releases;
+    return {ns / alarms, ns / released, checksum};
+}
+
+template <unsigned Arity>
+Result runHeap(std::vector<SimService> services, uint64_t targetReleases)
+{
+    IndexedMinHeap<int64_t, Arity> queue;
+    queue.reserve(services.size());
+    for (size_t i = 0; i < services.size(); i++)
+    {
+        queue.push(static_cast<uint32_t>(i), services[i].nextRelease);
+    }
+
+    uint64_t released = 0, alarms = 0;
+    int64_t now = queue.topKey();
+
+    auto start = std::chrono::steady_clock::now();
+    while (released < targetReleases)
+    {
+        while (queue.topKey() <= now)
+        {
+            auto &svc = services[queue.topId()];
+            svc.releases++;
+            released++;
+            svc.nextRelease += svc.periodNs;
+            queue.updateTop(svc.nextRelease);
+        }
+        alarms++;
+        now = queue.topKey();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    uint64_t checksum = 0;
+    for (auto &svc : services) checksum += svc.releases;
+    return {ns / alarms, ns / released, checksum};
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    uint64_t releases = 200000;
+    if (argc > 1)
+    {
+        releases = std::strtoull(argv[1], nullptr, 10);
+        if (releases == 0)
+        {
+            std::fprintf(stderr, "Usage: %s [releases_per_size]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("Dispatch cost per alarm / per release (ns), %llu releases per size\n",
+                static_cast<unsigned long long>(releases));
+    std::printf("%9s | %12s %12s | %12s %12s | %12s %12s\n",
+                "services", "linear/alarm", "linear/rel",
+                "2-ary/alarm", "2-ary/rel", "4-ary/alarm", "4-ary/rel");
+
+    for (size_t n : {10, 100, 1000, 10000})
+    {
+        auto services = makeServices(n, 1234);
+        Result linear = runLinear(services, releases);
+        Result binary = runHeap<2>(services, releases);
+        Result quad = runHeap<4>(services, releases);
+
+        if (linear.checksum != binary.checksum || linear.checksum != quad.checksum)
+        {
+            std::fprintf(stderr, "release count mismatch for %zu services\n", n);
+            return 1;
+        }
+
+        std::printf("%9zu | %12.1f %12.1f | %12.1f %12.1f | %12.1f %12.1f\n",
+                    n, linear.nsPerAlarm, linear.nsPerRelease,
+                    binary.nsPerAlarm, binary.nsPerRelease,
+                    quad.nsPerAlarm, quad.nsPerRelease);
+    }
+
+    return 0;
+}
@@ -58,8 +58,15 @@ int main()
 
     system("sudo pinctrl 17 op dl");
 
-    // Master alarm ticks every 10 ms, for example.
-    seq.startServices(/*masterIntervalMs=*/10);
+    // Per-job trace; decode with exer4redo/trace_decode
+    seq.enableTrace("sequencer.trace");
+
+    // Job markers in the kernel trace (needs root), see TraceMarker.hpp
+    // TraceMarker::open();
+
+    // One-shot timer armed for each nextRelease, no master tick.
+    // Use seq.startServices(/*masterIntervalMs=*/10) for a fixed 10 ms tick.
+    seq.startServices();
  
 
     // std::this_thread::sleep_for(std::chrono::seconds(10));